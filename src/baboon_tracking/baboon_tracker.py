@@ -3,6 +3,7 @@ Provides an algorithm for extracting baboons from drone footage.
 """
 from typing import Callable
 from baboon_tracking.preset_pipelines import preset_pipelines, update_preset_pipelines
+from pipeline import memory, telemetry, tracing
 from pipeline.parent_stage import ParentStage
 from pipeline.stage_result import StageResult
 
@@ -18,16 +19,48 @@ class BaboonTracker:
         update_preset_pipelines(input_file=input_file, runtime_config=runtime_config)
         self._pipeline = preset_pipelines[pipeline_name]
 
+        # Prints the runtime per stage every timing_interval frames, 0 only at the end.
+        self._timing_interval = (runtime_config or {}).get("timing_interval", 0)
+        self._steps = 0
+
+        # Writes a Chrome trace event file of every stage execution when the run ends.
+        trace = (runtime_config or {}).get("trace")
+        if trace:
+            tracing.start_tracing(trace)
+
+        # Writes the counters stages publish as one JSON line per frame.
+        telemetry_path = (runtime_config or {}).get("telemetry")
+        if telemetry_path:
+            telemetry.start_telemetry(telemetry_path)
+
+        # Reports the memory allocated per stage execution alongside its runtime.
+        if (runtime_config or {}).get("memory"):
+            memory.start_profiling()
+
         self._pipeline.on_init()
 
     def step(self) -> StageResult:
         """
         Runs one step of the algorithm.
         """
+        tracing.set_frame(self._steps)
+
         self._pipeline.before_execute()
         result = self._pipeline.execute()
         self._pipeline.after_execute()
 
+        # Frames leave the pipeline in order, so every frame up to the one this
+        # thread last worked on is complete.
+        if telemetry.recorder is not None:
+            telemetry.recorder.flush(tracing.get_frame())
+
+        ParentStage.buffer_pool.release(tracing.get_frame())
+
+        self._steps += 1
+        if self._timing_interval and self._steps % self._timing_interval == 0:
+            print("Runtime per stage after {steps} frames:".format(steps=self._steps))
+            self._pipeline.get_time().print_to_console()
+
         return result
 
     def run(self):
@@ -39,10 +72,13 @@ class BaboonTracker:
             result = self.step()
 
             if not result.continue_pipeline:
-                print("Average Runtime per stage:")
+                print("Runtime per stage:")
                 self._pipeline.get_time().print_to_console()
 
                 self._pipeline.on_destroy()
+                tracing.stop_tracing()
+                telemetry.stop_telemetry()
+                memory.stop_profiling()
 
                 return
 
@@ -8,6 +8,7 @@ from typing import Callable, Dict
 import cv2
 from baboon_tracking.mixins.capture_mixin import CaptureMixin
 from baboon_tracking.models.frame import Frame
+from library.display import has_display, show
 
 from pipeline.stage_result import StageResult
 from pipeline.decorators import runtime_config, stage
@@ -47,7 +48,7 @@ def show_result(function: Callable):
                 height = os.getenv("HEIGHT")
 
                 if not width or not height:
-                    if os.environ.get("DISPLAY", "") == "":
+                    if not has_display():
                         width = 0
                         height = 0
                     else:
@@ -72,16 +73,16 @@ def show_result(function: Callable):
 
                 im_size = (width, height)
 
-            if os.environ.get("DISPLAY", "") != "":
+            if has_display():
                 # This searches the current object for frame types.
                 if not frame_attributes:
                     frame_attributes = [
                         a for a in dir(self) if isinstance(getattr(self, a), Frame)
                     ]
 
-                # Display one cv2.imshow for each frame object.
+                # Display one window for each frame object.
                 for frame_attribute in frame_attributes:
-                    cv2.imshow(
+                    show(
                         "{stage_name}.{frame_attribute}".format(
                             stage_name=type(self).__name__,
                             frame_attribute=frame_attribute,
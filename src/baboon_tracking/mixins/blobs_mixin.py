@@ -0,0 +1,15 @@
+"""
+Mixin for returning blob statistics.
+"""
+import numpy as np
+
+
+class BlobsMixin:
+    """
+    Mixin for returning blob statistics.
+
+    Each row holds x1, y1, x2, y2, area, centroid x and centroid y of one blob.
+    """
+
+    def __init__(self):
+        self.blobs: np.ndarray = None
@@ -1,12 +0,0 @@
-"""
-Mixin for returning the intersected frames.
-"""
-
-
-class IntersectedFramesMixin:
-    """
-    Mixin for returning the intersected frames.
-    """
-
-    def __init__(self):
-        self.intersected_frames = []
@@ -1,12 +1,12 @@
 """
-Mixin for returning shifted masks.
+Mixin for returning the combined shifted mask.
 """
 
 
 class ShiftedMasksMixin:
     """
-    Mixin for returning shifted masks.
+    Mixin for returning the combined shifted mask.
     """
 
     def __init__(self):
-        self.shifted_masks = []
+        self.shifted_mask = None
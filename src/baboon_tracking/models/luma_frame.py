@@ -0,0 +1,36 @@
+"""
+Represents a frame from a video file that was decoded without color.
+"""
+import cv2
+import numpy as np
+
+from baboon_tracking.models.frame import Frame
+
+
+class LumaFrame(Frame):
+    """
+    Represents a frame from a video file that was decoded without color.
+    The BGR image is only created if a stage asks for it.
+    """
+
+    def __init__(self, luma: np.array, frame_number: int):
+        Frame.__init__(self, None, frame_number)
+
+        self._luma = luma
+
+    def get_luma(self) -> np.array:
+        """
+        Gets the luma plane of the frame.
+        """
+
+        return self._luma
+
+    def get_frame(self) -> np.array:
+        """
+        Gets the frame image as BGR.  The color information is not decoded, so the image is gray.
+        """
+
+        if self._frame is None:
+            self._frame = cv2.cvtColor(self._luma, cv2.COLOR_GRAY2BGR)
+
+        return self._frame
@@ -1,7 +1,7 @@
 """
 Provides an algorithm for extracting baboons from drone footage.
 """
-from typing import Dict
+from typing import Callable, Dict
 from baboon_tracking.stages.dead_reckoning import DeadReckoning
 from baboon_tracking.stages.display_progress import DisplayProgress
 from baboon_tracking.stages.draw_regions import DrawRegions
@@ -11,7 +11,7 @@ from baboon_tracking.stages.preprocess.preprocess_frame import PreprocessFrame
 
 # from baboon_tracking.stages.save_video import SaveVideo
 from baboon_tracking.stages.test_exit import TestExit
-from pipeline import Serial
+from pipeline import Graph, Pipelined, Serial
 from pipeline.factory import factory
 from pipeline.parent_stage import ParentStage
 from pipeline.stage import Stage
@@ -21,6 +21,11 @@ from config import get_latest_config, set_config
 
 
 preset_pipelines: Dict[str, Stage] = {}
+executions: Dict[str, Callable] = {
+    "serial": Serial,
+    "pipelined": Pipelined,
+    "graph": Graph,
+}
 
 
 def update_preset_pipelines(input_file="input.mp4", runtime_config=None):
@@ -30,10 +35,19 @@ def update_preset_pipelines(input_file="input.mp4", runtime_config=None):
 
     ParentStage.static_stages = []
 
-    preset_pipelines["default"] = Serial(
+    execution = "serial"
+    if runtime_config is not None and "execution" in runtime_config:
+        execution = runtime_config["execution"]
+
+    preset_pipelines["default"] = executions[execution](
         "BaboonTracker",
         runtime_config,
-        factory(GetVideoFrame, "./data/" + input_file),
+        factory(
+            GetVideoFrame,
+            "./data/" + input_file,
+            runtime_config,
+            ParentStage.buffer_pool,
+        ),
         PreprocessFrame,
         MotionDetector,
         DeadReckoning,
@@ -1,26 +1,122 @@
 import pathlib
-from typing import List
+from typing import Dict, List
 from baboon_tracking.mixins.baboons_mixin import BaboonsMixin
 from baboon_tracking.mixins.frame_mixin import FrameMixin
 from baboon_tracking.models.baboon import Baboon
-from library.region import bb_intersection_over_union
-from math import sqrt
-import shutil
-from os.path import exists
-import pickle
+from library.region import bb_intersection_over_union_arrays
+from library.track_store import TrackStore
+import numpy as np
 
-from pipeline import Stage
+from pipeline import Stage, telemetry
 from pipeline.stage_result import StageResult
-from pipeline.decorators import config, stage
+from pipeline.decorators import config, runtime_config, stage
 
+_TEMP_DIRECTORY = pathlib.Path("./temp/dead_reckoning")
 
-flatten = lambda t: [item for sublist in t for item in sublist]
+
+def _boxes(baboons: List[Baboon]):
+    return np.array([b.rectangle for b in baboons], dtype=np.int64).reshape(-1, 4)
+
+
+def _centroids(boxes: np.ndarray):
+    widths = (boxes[:, 2] - boxes[:, 0]).astype(np.float64)
+    heights = (boxes[:, 3] - boxes[:, 1]).astype(np.float64)
+
+    return widths / 2 + boxes[:, 0], heights / 2 + boxes[:, 1]
+
+
+def _expand_ranges(starts: np.ndarray, counts: np.ndarray):
+    """
+    Lists every (owner, index) with index in [starts[owner], starts[owner] + counts[owner]).
+    """
+    owners = np.repeat(np.arange(len(counts)), counts)
+    offsets = np.arange(counts.sum()) - np.repeat(np.cumsum(counts) - counts, counts)
+
+    return owners, np.repeat(starts, counts) + offsets
+
+
+def _grid_pairs(first_x, first_y, second_x, second_y, cell_size: float):
+    """
+    Pairs every second point with the first points in its own and the
+    neighbouring cells of a uniform grid, which holds all first points within
+    cell_size of it.
+    """
+    first_column = np.floor(first_x / cell_size).astype(np.int64)
+    first_row = np.floor(first_y / cell_size).astype(np.int64)
+    second_column = np.floor(second_x / cell_size).astype(np.int64)
+    second_row = np.floor(second_y / cell_size).astype(np.int64)
+
+    # Offset the cells by one so that the neighbours of every cell have
+    # non-negative coordinates inside the row major key space.
+    min_column = min(first_column.min(), second_column.min()) - 1
+    min_row = min(first_row.min(), second_row.min()) - 1
+    columns = max(first_column.max(), second_column.max()) - min_column + 2
+
+    first_keys = (first_row - min_row) * columns + first_column - min_column
+    order = np.argsort(first_keys, kind="stable")
+    first_keys = first_keys[order]
+
+    firsts = []
+    seconds = []
+    for row_offset in (-1, 0, 1):
+        for column_offset in (-1, 0, 1):
+            keys = (second_row - min_row + row_offset) * columns + (
+                second_column - min_column + column_offset
+            )
+            starts = np.searchsorted(first_keys, keys, side="left")
+            stops = np.searchsorted(first_keys, keys, side="right")
+
+            second, position = _expand_ranges(starts, stops - starts)
+            firsts.append(order[position])
+            seconds.append(second)
+
+    return np.concatenate(firsts), np.concatenate(seconds)
+
+
+def _overlap_pairs(boxes: np.ndarray):
+    """
+    Lists the pairs i < j of boxes whose x ranges overlap, sweeping over the
+    boxes sorted by their left edge.
+    """
+    order = np.argsort(boxes[:, 0], kind="stable")
+    lefts = boxes[order, 0]
+    stops = np.searchsorted(lefts, boxes[order, 2], side="right")
+
+    starts = np.arange(1, len(order) + 1)
+    first, position = _expand_ranges(starts, stops - starts)
+
+    first = order[first]
+    second = order[position]
+
+    return np.minimum(first, second), np.maximum(first, second)
+
+
+def _is_run_store(path: pathlib.Path) -> bool:
+    stem = path.name.split(".")[0]
+
+    return len(stem) == 32 and all(c in "0123456789abcdef" for c in stem)
+
+
+def _remove_stale_files():
+    """
+    Removes the per frame pickles, the shared store and the per run stores
+    that earlier versions left under ./temp.
+    """
+    for path in [
+        *_TEMP_DIRECTORY.glob("*.pickle"),
+        *[p for p in _TEMP_DIRECTORY.glob("*.bin*") if _is_run_store(p)],
+        pathlib.Path("./temp/dead_reckoning.bin"),
+        pathlib.Path("./temp/dead_reckoning.bin.index"),
+    ]:
+        if path.exists():
+            path.unlink()
 
 
 @config("dist_threshold", "dead_reckoning/dist_threshold")
 @config("same_region_threshold", "dead_reckoning/same_region_threshold")
 @stage("baboons")
 @stage("frame")
+@runtime_config("rconfig")
 class DeadReckoning(Stage, BaboonsMixin):
     def __init__(
         self,
@@ -28,6 +124,7 @@ class DeadReckoning(Stage, BaboonsMixin):
         same_region_threshold: float,
         baboons: BaboonsMixin,
         frame: FrameMixin,
+        rconfig: Dict[str, any],
     ) -> None:
         Stage.__init__(self)
         BaboonsMixin.__init__(self)
@@ -39,83 +136,98 @@ class DeadReckoning(Stage, BaboonsMixin):
         self._frame = frame
 
         self._counter = 0
-        self._all_baboons = {}
 
-        self._create_directory()
+        # Association only looks one frame back, older frames are spilled to
+        # disk.  Unless the store is asked for, they go to a temporary file.
+        track_store = rconfig.get("track_store")
+        if not track_store:
+            _remove_stale_files()
+
+        self._all_baboons = TrackStore(track_store or None)
+
+    def _associate(self, prev_baboons: List[Baboon], baboons: List[Baboon]):
+        """
+        Gives each current baboon the identity of the nearest previous baboon
+        within dist_threshold, starting with the current baboons that have
+        the closest match.
+        """
+        prev_x, prev_y = _centroids(_boxes(prev_baboons))
+        curr_x, curr_y = _centroids(_boxes(baboons))
+
+        prev, curr = _grid_pairs(
+            prev_x, prev_y, curr_x, curr_y, max(float(self._dist_threshold), 1.0)
+        )
 
-    def _create_directory(self):
-        if exists("./temp/dead_reckoning"):
-            shutil.rmtree("./temp/dead_reckoning")
+        telemetry.count("association_candidate_pairs", len(prev))
 
-        pathlib.Path("./temp").mkdir(exist_ok=True)
-        pathlib.Path("./temp/dead_reckoning").mkdir(exist_ok=True)
+        distances = np.sqrt(
+            (prev_x[prev] - curr_x[curr]) ** 2 + (prev_y[prev] - curr_y[curr]) ** 2
+        )
+        within = distances <= self._dist_threshold
+        prev = prev[within]
+        curr = curr[within]
+        distances = distances[within]
 
-    def _centroid(self, baboon: Baboon):
-        x1, y1, x2, y2 = baboon.rectangle
+        closest = np.full(len(baboons), np.inf)
+        np.minimum.at(closest, curr, distances)
 
-        width = float(x2 - x1)
-        height = float(y2 - y1)
+        # Current baboons by their closest distance, then their candidates by distance.
+        order = np.lexsort((prev, distances, curr, closest[curr]))
 
-        return (width / 2 + x1, height / 2 + y1)
+        used_identities = set()
+        matched = [False] * len(baboons)
+        for p, c in zip(prev[order].tolist(), curr[order].tolist()):
+            if matched[c] or prev_baboons[p].identity in used_identities:
+                continue
 
-    def _dist(self, first: Baboon, second: Baboon):
-        first_center = self._centroid(first)
-        second_center = self._centroid(second)
+            baboons[c].identity = prev_baboons[p].identity
+            baboons[c].id_str = prev_baboons[p].id_str
 
-        return sqrt(
-            (first_center[0] - second_center[0]) ** 2
-            + (first_center[1] - second_center[1]) ** 2
-        )
+            used_identities.add(prev_baboons[p].identity)
+            matched[c] = True
 
-    def _calc_region_overlap(self, first: Baboon, second: Baboon):
-        return bb_intersection_over_union(first.rectangle, second.rectangle)
+    def _same_baboons(self, baboons: List[Baboon]):
+        """
+        Flags the baboons overlapping another one by at least
+        same_region_threshold. Of each overlapping pair, the one without an
+        identity or with the larger identity is flagged, or both if that is a tie.
+        """
+        boxes = _boxes(baboons)
 
-    def _make_tuple(self, first: Baboon, second: Baboon, overlay: float):
-        if first.identity is not None and second.identity is None:
-            return (first, second, overlay)
-        if first.identity is None and second.identity is not None:
-            return (second, first, overlay)
-        if first.identity is None and second.identity is None:
-            return (first, second, overlay)
+        if self._same_region_threshold > 0:
+            first, second = _overlap_pairs(boxes)
+        else:
+            first, second = np.triu_indices(len(baboons), k=1)
 
-        id1 = min(first.identity, second.identity)
-        if first.identity == id1:
-            return (first, second, overlay)
+        telemetry.count("same_region_candidate_pairs", len(first))
 
-        return (second, first, overlay)
+        overlap = bb_intersection_over_union_arrays(boxes[first], boxes[second])
+        same = overlap >= self._same_region_threshold
+        first = first[same]
+        second = second[same]
 
-    def has_frame(self, frame_number):
-        return frame_number in self._all_baboons or exists(
-            "./temp/dead_reckoning/{frame_number}.pickle".format(
-                frame_number=frame_number
-            )
+        # Baboons without an identity sort after every identity.
+        identities = np.array(
+            [np.inf if b.identity is None else b.identity for b in baboons]
         )
 
-    def get(self, frame_number: int) -> List[Baboon]:
-        if frame_number in self._all_baboons:
-            return self._all_baboons[frame_number]
-
-        file_path = "./temp/dead_reckoning/{frame_number}.pickle".format(
-            frame_number=frame_number
-        )
+        flagged = np.zeros(len(baboons), dtype=bool)
+        flagged[first[identities[first] >= identities[second]]] = True
+        flagged[second[identities[second] >= identities[first]]] = True
 
-        if exists(file_path):
-            with open(file_path, "rb") as f:
-                return pickle.load(f)
+        return flagged
 
-    def set(self, frame_number: int, baboons: List[Baboon]):
-        self._all_baboons[frame_number] = baboons
+    def has_frame(self, frame_number):
+        return frame_number in self._all_baboons
 
-        if len(self._all_baboons) > 2:
-            min_frame = min(self._all_baboons.keys())
-            save = self._all_baboons.pop(min_frame)
+    def get(self, frame_number: int) -> List[Baboon]:
+        return self._all_baboons.get(frame_number)
 
-            file_path = "./temp/dead_reckoning/{frame_number}.pickle".format(
-                frame_number=min_frame
-            )
+    def set(self, frame_number: int, baboons: List[Baboon]):
+        self._all_baboons.set(frame_number, baboons)
 
-            with open(file_path, "wb") as f:
-                pickle.dump(save, f)
+    def on_destroy(self) -> None:
+        self._all_baboons.close()
 
     def execute(self) -> StageResult:
         prev_frame = self._frame.frame.get_frame_number() - 1
@@ -124,68 +236,24 @@ class DeadReckoning(Stage, BaboonsMixin):
         if self.has_frame(prev_frame):
             prev_baboons = self.get(prev_frame)
 
-            distances = [
-                [(p, b, self._dist(p, b)) for p in prev_baboons]
-                for b in self._baboons.baboons
-            ]
-            distances = [
-                [(p, b, d) for p, b, d in dist if d <= self._dist_threshold]
-                for dist in distances
-            ]
-            distances = [d for d in distances if d]
-
-            for dist in distances:
-                dist.sort(key=lambda x: x[2])
-
-            distances.sort(key=lambda x: x[0][2])
-            while distances:
-                dist_list = distances.pop(0)
-                prev, curr, _ = dist_list.pop(0)
-
-                curr.identity = prev.identity
-                curr.id_str = prev.id_str
-
-                for dist_list in distances:
-                    for item in [
-                        (p, b, d)
-                        for p, b, d in dist_list
-                        if b.identity == curr.identity or p.identity == curr.identity
-                    ]:
-                        dist_list.remove(item)
-
-                    if not dist_list:
-                        distances.remove(dist_list)
+            if prev_baboons and baboons:
+                self._associate(prev_baboons, baboons)
 
             prev_ids = {p.identity: p for p in prev_baboons}
             curr_ids = [b.identity for b in baboons if b.identity is not None]
 
             for id_str in curr_ids:
-            	if id_str in prev_ids:
-                	prev_ids.pop(id_str)
+                if id_str in prev_ids:
+                    prev_ids.pop(id_str)
 
             prev_items = [prev_ids[i] for i in prev_ids]
 
             baboons.extend(prev_items)
 
-        baboon_regions = flatten(
-            [
-                [
-                    (b1, b2, self._calc_region_overlap(b1, b2))
-                    for b2 in baboons
-                    if b1 != b2
-                ]
-                for b1 in baboons
+        if baboons:
+            baboons = [
+                b for b, same in zip(baboons, self._same_baboons(baboons)) if not same
             ]
-        )
-        same_baboons = {
-            self._make_tuple(b1, b2, o)
-            for b1, b2, o in baboon_regions
-            if o >= self._same_region_threshold
-        }
-
-        for _, baboon, _ in same_baboons:
-            if baboon in baboons:
-                baboons.remove(baboon)
 
         for baboon in self._baboons.baboons:
             if baboon.identity is not None:
@@ -199,4 +267,3 @@ class DeadReckoning(Stage, BaboonsMixin):
         self.baboons = baboons
 
         return StageResult(True, True)
-
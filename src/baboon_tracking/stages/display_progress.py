@@ -25,13 +25,11 @@ class DisplayProgress(Stage):
         self._frame = frame
 
     def on_init(self) -> None:
-        self._progress = tqdm(range(self._frame_count)).__iter__()
+        self._progress = tqdm(total=self._frame_count)
 
     def execute(self) -> StageResult:
-        idx = next(self._progress)
-
-        while idx < self._frame.frame.get_frame_number():
-            idx = next(self._progress)
+        # Frames are numbered from one, so the last frame completes the bar.
+        self._progress.update(self._frame.frame.get_frame_number() - self._progress.n)
 
         return StageResult(True, True)
 
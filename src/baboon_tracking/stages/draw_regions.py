@@ -2,6 +2,8 @@
 Implements a stage that takes the input frame and draws the regions over it.
 """
 
+from typing import Dict
+
 import cv2
 from baboon_tracking.decorators.save_result import save_result
 from baboon_tracking.decorators.show_result import show_result
@@ -9,7 +11,7 @@ from baboon_tracking.mixins.frame_mixin import FrameMixin
 from baboon_tracking.mixins.baboons_mixin import BaboonsMixin
 from baboon_tracking.models.frame import Frame
 from pipeline import Stage
-from pipeline.decorators import stage
+from pipeline.decorators import runtime_config, stage
 from pipeline.stage_result import StageResult
 
 
@@ -17,19 +19,30 @@ from pipeline.stage_result import StageResult
 @show_result
 @stage("frame")
 @stage("baboons")
+@runtime_config("rconfig")
 class DrawRegions(Stage):
     """
     Implements a stage that takes the input frame and draws the regions over it.
     """
 
-    def __init__(self, frame: FrameMixin, baboons: BaboonsMixin) -> None:
+    def __init__(
+        self, frame: FrameMixin, baboons: BaboonsMixin, rconfig: Dict[str, any]
+    ) -> None:
         Stage.__init__(self)
 
         self._frame = frame
         self._baboons = baboons
         self.region_frame: Frame = None
 
+        # Only show_result and save_result consume the drawn regions.
+        self._enabled = ("display" not in rconfig or rconfig["display"]) or (
+            "save" not in rconfig or rconfig["save"]
+        )
+
     def execute(self) -> StageResult:
+        if not self._enabled:
+            return StageResult(True, True)
+
         region_frame = self._frame.frame.get_frame().copy()
 
         rectangles = [(b.rectangle, b.id_str) for b in self._baboons.baboons]
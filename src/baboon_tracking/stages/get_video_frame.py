@@ -1,12 +1,18 @@
 """
 Get a video frame from a video file.
 """
+from typing import Dict
+
 import cv2
+import numpy as np
 from baboon_tracking.mixins.capture_mixin import CaptureMixin
 from baboon_tracking.mixins.frame_mixin import FrameMixin
 from baboon_tracking.models.frame import Frame
+from baboon_tracking.models.luma_frame import LumaFrame
+from library.video_reader import VideoReader
 
 from pipeline import Stage
+from pipeline.buffer_pool import BufferPool
 from pipeline.stage_result import StageResult
 
 
@@ -15,7 +21,12 @@ class GetVideoFrame(Stage, FrameMixin, CaptureMixin):
     Get a video frame from a video file.
     """
 
-    def __init__(self, video_path: str):
+    def __init__(
+        self,
+        video_path: str,
+        runtime_config: Dict[str, any] = None,
+        pool: BufferPool = None,
+    ):
         FrameMixin.__init__(self)
         CaptureMixin.__init__(self)
         Stage.__init__(self)
@@ -26,6 +37,42 @@ class GetVideoFrame(Stage, FrameMixin, CaptureMixin):
         self.fps = self._capture.get(cv2.CAP_PROP_FPS)
         self.frame_count = self._capture.get(cv2.CAP_PROP_FRAME_COUNT)
 
+        read_ahead = 0
+        if runtime_config is not None and "read_ahead" in runtime_config:
+            read_ahead = runtime_config["read_ahead"]
+
+        # Without RGB conversion the FFmpeg backend returns the Y plane of the decoded YUV frame.
+        self._luma = (
+            runtime_config is not None
+            and "luma" in runtime_config
+            and runtime_config["luma"]
+            and self._capture.set(cv2.CAP_PROP_CONVERT_RGB, 0)
+        )
+        luma_range = "limited"
+        if runtime_config is not None and "luma_range" in runtime_config:
+            luma_range = runtime_config["luma_range"]
+
+        # A Y plane in the limited 16-235 range is stretched to match a BGR to gray conversion.
+        # OpenCV does not report the range of the stream, so full range video has to be declared.
+        self._luma_table = None
+        if luma_range == "limited":
+            self._luma_table = np.clip(
+                np.round((np.arange(256) - 16) * 255.0 / 219.0), 0, 255
+            ).astype(np.uint8)
+
+        self._shape = (self.frame_height, self.frame_width, 3)
+        if self._luma:
+            self._shape = (self.frame_height, self.frame_width)
+
+        self._pool = pool if pool is not None else BufferPool()
+
+        # The decoder thread works on no frame, so the buffers it gets are not leased until read.
+        self._reader: VideoReader = None
+        if read_ahead > 0:
+            self._reader = VideoReader(
+                self._capture, read_ahead, lambda: self._pool.get(self._shape)
+            )
+
         self._frame_number = 1
 
     def execute(self) -> StageResult:
@@ -33,9 +80,36 @@ class GetVideoFrame(Stage, FrameMixin, CaptureMixin):
         Get a video frame from a video file.
         """
 
-        success, frame = self._capture.read()
+        if self._reader is None:
+            buffer = self._pool.get(self._shape)
+            success, decoded = self._capture.read(buffer)
+        else:
+            buffer = None
+            success, decoded = self._reader.read()
+
+        # The decoded buffer is decoded into again once this frame has left the pipeline.
+        if success and decoded is not buffer:
+            self._pool.lease(decoded)
+
+        if success and self._luma:
+            # Backends that ignore CAP_PROP_CONVERT_RGB still return BGR.
+            if len(decoded.shape) == 3:
+                luma = cv2.cvtColor(decoded, cv2.COLOR_BGR2GRAY)
+            elif self._luma_table is not None:
+                luma = cv2.LUT(decoded, self._luma_table, dst=decoded)
+            else:
+                luma = decoded
+
+            self.frame = LumaFrame(luma, self._frame_number)
+        else:
+            self.frame = Frame(decoded, self._frame_number)
 
-        self.frame = Frame(frame, self._frame_number)
         self._frame_number += 1
 
         return StageResult(success, success)
+
+    def on_destroy(self) -> None:
+        if self._reader is not None:
+            self._reader.stop()
+
+        self._capture.release()
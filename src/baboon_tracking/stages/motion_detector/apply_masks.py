@@ -2,19 +2,21 @@
 Applies the masks to the moving foreground.
 """
 
-import numpy as np
+import cv2
 from baboon_tracking.mixins.frame_mixin import FrameMixin
 from baboon_tracking.mixins.moving_foreground_mixin import MovingForegroundMixin
 from baboon_tracking.mixins.shifted_masks_mixin import ShiftedMasksMixin
 from baboon_tracking.models.frame import Frame
 from pipeline import Stage
+from pipeline.buffer_pool import BufferPool
 from pipeline.stage_result import StageResult
-from pipeline.decorators import stage
+from pipeline.decorators import buffer_pool, stage
 
 
 @stage("moving_foreground")
 @stage("shifted_masks")
 @stage("frame")
+@buffer_pool("pool")
 class ApplyMasks(Stage, MovingForegroundMixin):
     """
     Applies the masks to the moving foreground.
@@ -25,6 +27,7 @@ class ApplyMasks(Stage, MovingForegroundMixin):
         moving_foreground: MovingForegroundMixin,
         shifted_masks: ShiftedMasksMixin,
         frame: FrameMixin,
+        pool: BufferPool,
     ) -> None:
         Stage.__init__(self)
         MovingForegroundMixin.__init__(self)
@@ -32,15 +35,20 @@ class ApplyMasks(Stage, MovingForegroundMixin):
         self._moving_foreground = moving_foreground
         self._shifted_masks = shifted_masks
         self._frame = frame
+        self._pool = pool
 
     def execute(self) -> StageResult:
         # This cleans up the edges after performing image registration.
-        for mask in self._shifted_masks.shifted_masks:
-            self.moving_foreground = Frame(
-                np.multiply(
-                    self._moving_foreground.moving_foreground.get_frame(), mask
-                ),
-                self._frame.frame.get_frame_number(),
-            )
+        # The unmasked foreground belongs to the stage that computed it.
+        unmasked = self._moving_foreground.moving_foreground.get_frame()
+        moving_foreground = cv2.bitwise_and(
+            unmasked,
+            self._shifted_masks.shifted_mask,
+            dst=self._pool.get_like(unmasked),
+        )
+
+        self.moving_foreground = Frame(
+            moving_foreground, self._frame.frame.get_frame_number()
+        )
 
         return StageResult(True, True)
@@ -3,6 +3,7 @@ Computes the moving foreground using the subcomponents previously computed
 """
 import math
 import numpy as np
+from numba import jit, prange
 
 from baboon_tracking.mixins.foreground_mixin import ForegroundMixin
 from baboon_tracking.mixins.frame_mixin import FrameMixin
@@ -12,9 +13,22 @@ from baboon_tracking.mixins.history_of_dissimilarity_mixin import (
 from baboon_tracking.mixins.moving_foreground_mixin import MovingForegroundMixin
 from baboon_tracking.mixins.weights_mixin import WeightsMixin
 from baboon_tracking.models.frame import Frame
-from pipeline import Stage
+from pipeline import Stage, telemetry
+from pipeline.buffer_pool import BufferPool
 from pipeline.stage_result import StageResult
-from pipeline.decorators import config, stage
+from pipeline.decorators import buffer_pool, config, stage
+
+
+@jit(nopython=True, parallel=True)
+def _classify(decision_table, weights, foreground, dissimilarity, moving_foreground):
+    height, width = moving_foreground.shape
+
+    # pylint: disable=not-an-iterable
+    for y in prange(height):
+        for x in range(width):
+            moving_foreground[y, x] = decision_table[
+                weights[y, x], foreground[y, x], dissimilarity[y, x]
+            ]
 
 
 @stage("history_of_dissimilarity")
@@ -22,6 +36,7 @@ from pipeline.decorators import config, stage
 @stage("weights")
 @stage("frame_mixin")
 @config(parameter_name="history_frames", key="motion_detector/history_frames")
+@buffer_pool("pool")
 class ComputeMovingForeground(Stage, MovingForegroundMixin):
     """
     Computes the moving foreground using the subcomponents previously computed
@@ -34,6 +49,7 @@ class ComputeMovingForeground(Stage, MovingForegroundMixin):
         weights: WeightsMixin,
         frame_mixin: FrameMixin,
         history_frames: int,
+        pool: BufferPool,
     ) -> None:
         Stage.__init__(self)
         MovingForegroundMixin.__init__(self)
@@ -43,6 +59,16 @@ class ComputeMovingForeground(Stage, MovingForegroundMixin):
         self._weights = weights
         self._frame = frame_mixin
         self._history_frames = history_frames
+        self._pool = pool
+
+        # The decision only depends on the weight, foreground and dissimilarity
+        # of a pixel, so classify every possible combination once up front.
+        weights, foreground, dissimilarity = np.indices(
+            (history_frames, 256, 256), dtype=np.uint8
+        )
+        self._decision_table = self._get_moving_foreground(
+            weights, foreground, dissimilarity
+        )
 
     def execute(self) -> StageResult:
         weights = self._weights.weights
@@ -51,9 +77,23 @@ class ComputeMovingForeground(Stage, MovingForegroundMixin):
             self._history_of_dissimilarity.history_of_dissimilarity
         )
 
+        moving_foreground = self._pool.get(foreground.shape, np.uint8)
+        _classify(
+            self._decision_table,
+            weights,
+            foreground,
+            history_of_dissimilarity,
+            moving_foreground,
+        )
+
+        if telemetry.recorder is not None:
+            telemetry.record(
+                "moving_foreground_fraction",
+                np.count_nonzero(moving_foreground) / moving_foreground.size,
+            )
+
         self.moving_foreground = Frame(
-            self._get_moving_foreground(weights, foreground, history_of_dissimilarity),
-            self._frame.frame.get_frame_number(),
+            moving_foreground, self._frame.frame.get_frame_number()
         )
 
         return StageResult(True, True)
@@ -0,0 +1,97 @@
+"""
+Computes the weights, history of dissimilarity and unioned intersections in one pass.
+"""
+
+import numpy as np
+from numba import jit, prange
+from baboon_tracking.mixins.history_of_dissimilarity_mixin import (
+    HistoryOfDissimilarityMixin,
+)
+from baboon_tracking.mixins.quantized_frames_mixin import QuantizedFramesMixin
+from baboon_tracking.mixins.shifted_history_frames_mixin import (
+    ShiftedHistoryFramesMixin,
+)
+from baboon_tracking.mixins.unioned_frames_mixin import UnionedFramesMixin
+from baboon_tracking.mixins.weights_mixin import WeightsMixin
+from pipeline import Stage
+from pipeline.buffer_pool import BufferPool
+from pipeline.decorators import buffer_pool, stage
+from pipeline.stage_result import StageResult
+
+
+@jit(nopython=True, parallel=True)
+def _execute(frames, q_frames, weights, history_of_dissimilarity, union):
+    count = len(frames)
+    height, width = weights.shape
+
+    # pylint: disable=not-an-iterable
+    for y in prange(height):
+        for x in range(width):
+            weight = 0
+            dissimilarity = 0
+            union_value = 0
+
+            for i in range(1, count):
+                q_difference = np.int32(q_frames[i][y, x]) - np.int32(
+                    q_frames[i - 1][y, x]
+                )
+                if abs(q_difference) <= 1:
+                    weight += 1
+                    continue
+
+                previous = frames[i - 1][y, x]
+                dissimilarity += abs(np.int32(frames[i][y, x]) - np.int32(previous))
+
+                # The newest intersection with a non zero pixel wins the union.
+                if previous != 0:
+                    union_value = previous
+
+            weights[y, x] = weight
+            history_of_dissimilarity[y, x] = dissimilarity // count
+            union[y, x] = union_value
+
+
+@stage("shifted_history_frames")
+@stage("quantized_frames")
+@buffer_pool("pool")
+class ComputeTemporalStatistics(
+    Stage, WeightsMixin, HistoryOfDissimilarityMixin, UnionedFramesMixin
+):
+    """
+    Computes the weights, history of dissimilarity and unioned intersections in one pass.
+
+    Only compares each pair of quantized frames once and without allocating per pair temporaries.
+    """
+
+    def __init__(
+        self,
+        shifted_history_frames: ShiftedHistoryFramesMixin,
+        quantized_frames: QuantizedFramesMixin,
+        pool: BufferPool,
+    ) -> None:
+        Stage.__init__(self)
+        WeightsMixin.__init__(self)
+        HistoryOfDissimilarityMixin.__init__(self)
+        UnionedFramesMixin.__init__(self)
+
+        self._shifted_history_frames = shifted_history_frames
+        self._quantized_frames = quantized_frames
+        self._pool = pool
+
+    def execute(self) -> StageResult:
+        frames = tuple(
+            f.get_frame() for f in self._shifted_history_frames.shifted_history_frames
+        )
+        q_frames = tuple(self._quantized_frames.quantized_frames)
+
+        weights = self._pool.get(frames[0].shape, np.uint8)
+        history_of_dissimilarity = self._pool.get(frames[0].shape, np.uint8)
+        union = self._pool.get(frames[0].shape, np.uint8)
+
+        _execute(frames, q_frames, weights, history_of_dissimilarity, union)
+
+        self.weights = weights
+        self.history_of_dissimilarity = history_of_dissimilarity
+        self.unioned_frames = union
+
+        return StageResult(True, True)
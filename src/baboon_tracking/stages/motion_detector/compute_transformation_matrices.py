@@ -9,10 +9,11 @@ from baboon_tracking.mixins.transformation_matrices_mixin import (
     TransformationMatricesMixin,
 )
 from baboon_tracking.models.frame import Frame
+from library.ssc import select_keypoints
+from pipeline import telemetry
 from pipeline.decorators import config, stage
 from pipeline.stage import Stage
 from pipeline.stage_result import StageResult
-from third_party.ssc import ssc
 
 
 @config(
@@ -30,6 +31,14 @@ from third_party.ssc import ssc
 @config(
     parameter_name="ssc_tolerence", key="motion_detector/registration/ssc_tolerence",
 )
+@config(
+    parameter_name="chain_registration",
+    key="motion_detector/registration/chain_registration",
+)
+@config(
+    parameter_name="direct_registration_interval",
+    key="motion_detector/registration/direct_registration_interval",
+)
 @stage("preprocessed_frame")
 @stage("history_frames")
 class ComputeTransformationMatrices(Stage, TransformationMatricesMixin):
@@ -43,6 +52,8 @@ class ComputeTransformationMatrices(Stage, TransformationMatricesMixin):
         ransac_max_error: float,
         ssc_num_ret_points: int,
         ssc_tolerence: float,
+        chain_registration: int,
+        direct_registration_interval: int,
         preprocessed_frame: PreprocessedFrameMixin,
         history_frames: HistoryFramesMixin,
     ):
@@ -56,22 +67,35 @@ class ComputeTransformationMatrices(Stage, TransformationMatricesMixin):
         self._ransac_max_error = ransac_max_error
         self._ssc_num_ret_points = ssc_num_ret_points
         self._ssc_tolerence = ssc_tolerence
+        self._chain_registration = chain_registration == 1
+        self._direct_registration_interval = direct_registration_interval
+        # Maps a frame to the transformation matrix from the frame before it.
+        self._step_transformation_matrices = dict()
+        self._frames_since_direct_registration = 0
 
         self._preprocessed_frame = preprocessed_frame
         self._history_frames = history_frames
 
         history_frames.history_frame_popped.subscribe(self._feature_hash.pop)
+        history_frames.history_frame_popped.subscribe(
+            lambda f: self._step_transformation_matrices.pop(f, None)
+        )
 
     def _detect_and_compute(self, frame: Frame):
         if frame not in self._feature_hash:
             keypoints = self._fast.detect(frame.get_frame(), None)
-            keypoints = ssc(
+
+            selected = select_keypoints(
                 keypoints,
-                10000,
-                0.1,
+                self._ssc_num_ret_points,
+                self._ssc_tolerence,
                 frame.get_frame().shape[1],
                 frame.get_frame().shape[0],
             )
+            telemetry.count("fast_keypoints", len(keypoints))
+            telemetry.count("ssc_keypoints", len(selected))
+
+            keypoints = [keypoints[i] for i in selected]
             descriptors = self._orb.compute(frame.get_frame(), keypoints)
 
             keypoints = descriptors[0]
@@ -92,7 +116,7 @@ class ComputeTransformationMatrices(Stage, TransformationMatricesMixin):
         matches = matcher.match(descriptors1, descriptors2, None)
 
         # Sort matches by score
-        matches.sort(key=lambda x: x.distance, reverse=False)
+        matches = sorted(matches, key=lambda x: x.distance, reverse=False)
 
         # Remove not so good matches
         num_good_matches = int(len(matches) * self._good_match_percent)
@@ -107,10 +131,16 @@ class ComputeTransformationMatrices(Stage, TransformationMatricesMixin):
             points2[i, :] = keypoints2[match.trainIdx].pt
 
         # Find homography
-        transformation_matrix, _ = cv2.findHomography(
+        transformation_matrix, inliers = cv2.findHomography(
             points1, points2, cv2.RANSAC, self._ransac_max_error
         )
 
+        telemetry.count("good_matches", num_good_matches)
+        if telemetry.recorder is not None and inliers is not None:
+            telemetry.record(
+                "ransac_inlier_ratio", np.count_nonzero(inliers) / len(inliers)
+            )
+
         return transformation_matrix
 
     def execute(self) -> StageResult:
@@ -124,8 +154,51 @@ class ComputeTransformationMatrices(Stage, TransformationMatricesMixin):
         processed_frame = self._preprocessed_frame.processed_frame
         history_frames = self._history_frames.history_frames
 
-        self.transformation_matrices = [
-            self._register(f, processed_frame) for f in history_frames
-        ]
+        if self._should_register_directly():
+            self.transformation_matrices = [
+                self._register(f, processed_frame) for f in history_frames
+            ]
+        else:
+            self.transformation_matrices = self._chain(history_frames)
 
         return StageResult(True, True)
+
+    def _should_register_directly(self):
+        if not self._chain_registration:
+            return True
+
+        self._frames_since_direct_registration += 1
+        if (
+            self._direct_registration_interval > 0
+            and self._frames_since_direct_registration
+            >= self._direct_registration_interval
+        ):
+            self._frames_since_direct_registration = 0
+            return True
+
+        return False
+
+    def _chain(self, history_frames):
+        """
+        Composes the transformation matrices between consecutive history frames,
+        so only the newest frame needs to be registered against its predecessor.
+        """
+        history_frames = list(history_frames)
+
+        for previous, current in zip(history_frames[:-1], history_frames[1:]):
+            if current not in self._step_transformation_matrices:
+                self._step_transformation_matrices[current] = self._register(
+                    previous, current
+                )
+
+        # The newest history frame is the current frame.
+        transformation_matrix = np.identity(3)
+        transformation_matrices = [transformation_matrix]
+        for frame in reversed(history_frames[1:]):
+            transformation_matrix = np.matmul(
+                transformation_matrix, self._step_transformation_matrices[frame]
+            )
+            transformation_matrix = transformation_matrix / transformation_matrix[2, 2]
+            transformation_matrices.insert(0, transformation_matrix)
+
+        return transformation_matrices
@@ -1,32 +1,85 @@
 """
-Detect blobs using the built in OpenCV blob detector.
+Detect blobs as the connected components of the moving foreground.
 """
+from typing import Dict
 import cv2
+import numpy as np
 from baboon_tracking.decorators.show_result import show_result
 from baboon_tracking.mixins.blob_image_mixin import BlobImageMixin
+from baboon_tracking.mixins.blobs_mixin import BlobsMixin
 from baboon_tracking.mixins.baboons_mixin import BaboonsMixin
 from baboon_tracking.mixins.moving_foreground_mixin import MovingForegroundMixin
 from baboon_tracking.models.baboon import Baboon
 from baboon_tracking.models.frame import Frame
+from library.display import has_display
 
-from pipeline import Stage
-from pipeline.decorators import stage
+from pipeline import Stage, telemetry
+from pipeline.decorators import config, runtime_config, stage
 from pipeline.stage_result import StageResult
 
 
+def _runs(occupied):
+    """
+    Returns the start and end of every run of True in occupied.
+    """
+    edges = np.flatnonzero(np.diff(occupied.view(np.int8), prepend=0, append=0))
+
+    return zip(edges[::2].tolist(), edges[1::2].tolist())
+
+
+def _connected_components(mask):
+    """
+    Returns the stats and centroids of the 8-connected components of mask.
+    """
+    stats = [np.empty((0, 5), dtype=np.int32)]
+    centroids = [np.empty((0, 2))]
+
+    # Components never cross an empty row, or an empty column of a band of
+    # rows, so only the tiles between those are labelled. Labelling costs the
+    # same for every pixel, and most of a sparse mask is never looked at.
+    for y1, y2 in _runs(mask.max(axis=1) != 0):
+        band = mask[y1:y2]
+        for x1, x2 in _runs(band.max(axis=0) != 0):
+            _, _, tile, centers = cv2.connectedComponentsWithStatsWithAlgorithm(
+                band[:, x1:x2], 8, cv2.CV_32S, cv2.CCL_GRANA
+            )
+
+            # Label 0 is the background.
+            tile = tile[1:]
+            tile[:, cv2.CC_STAT_LEFT] += x1
+            tile[:, cv2.CC_STAT_TOP] += y1
+            stats.append(tile)
+            centroids.append(centers[1:] + (x1, y1))
+
+    return np.concatenate(stats), np.concatenate(centroids)
+
+
 @show_result
+@config("min_size", "motion_detector/min_size_filter/min_size")
 @stage("moving_foreground")
-class DetectBlobs(Stage, BlobImageMixin, BaboonsMixin):
+@runtime_config("rconfig")
+class DetectBlobs(Stage, BlobImageMixin, BaboonsMixin, BlobsMixin):
     """
-    Detect blobs using the built in OpenCV blob detector.
+    Detect blobs as the connected components of the moving foreground.
+    Blobs whose bounding box is smaller than min_size are dropped.
     """
 
-    def __init__(self, moving_foreground: MovingForegroundMixin,) -> None:
+    def __init__(
+        self,
+        min_size: int,
+        moving_foreground: MovingForegroundMixin,
+        rconfig: Dict[str, any],
+    ) -> None:
         BlobImageMixin.__init__(self)
         BaboonsMixin.__init__(self)
+        BlobsMixin.__init__(self)
 
+        self._min_size = min_size
         self._moving_foregrouned = moving_foreground
 
+        # Only show_result consumes the blob image, and only if it can open windows.
+        self._draw = rconfig.get("display", False) and has_display()
+
         Stage.__init__(self)
 
     def execute(self) -> StageResult:
@@ -37,21 +90,34 @@ class DetectBlobs(Stage, BlobImageMixin, BaboonsMixin):
 
         foreground_mask = self._moving_foregrouned.moving_foreground.get_frame()
 
-        contours, _ = cv2.findContours(
-            foreground_mask, cv2.RETR_LIST, cv2.CHAIN_APPROX_SIMPLE
-        )
-        rectangles = [cv2.boundingRect(c) for c in contours]
-        rectangles = [(r[0], r[1], r[0] + r[2], r[1] + r[3]) for r in rectangles]
+        stats, centroids = _connected_components(foreground_mask)
+        widths = stats[:, cv2.CC_STAT_WIDTH]
+        heights = stats[:, cv2.CC_STAT_HEIGHT]
+        keep = widths * heights >= self._min_size
 
-        blob_image = cv2.cvtColor(foreground_mask, cv2.COLOR_GRAY2BGR)
-        for rect in rectangles:
-            blob_image = cv2.rectangle(
-                blob_image, (rect[0], rect[1]), (rect[2], rect[3]), (0, 255, 0), 2
-            )
+        telemetry.count("components", len(stats))
+        telemetry.count("blobs", np.count_nonzero(keep))
 
-        self.blob_image = Frame(
-            blob_image, self._moving_foregrouned.moving_foreground.get_frame_number(),
+        x1 = stats[keep, cv2.CC_STAT_LEFT]
+        y1 = stats[keep, cv2.CC_STAT_TOP]
+        boxes = np.column_stack((x1, y1, x1 + widths[keep], y1 + heights[keep]))
+        self.blobs = np.column_stack(
+            (boxes, stats[keep, cv2.CC_STAT_AREA], centroids[keep])
         )
 
-        self.baboons = [Baboon(r) for r in rectangles]
+        rectangles = list(map(tuple, boxes.tolist()))
+        self.baboons = list(map(Baboon, rectangles))
+
+        if self._draw:
+            blob_image = cv2.cvtColor(foreground_mask, cv2.COLOR_GRAY2BGR)
+            for rect in rectangles:
+                blob_image = cv2.rectangle(
+                    blob_image, (rect[0], rect[1]), (rect[2], rect[3]), (0, 255, 0), 2
+                )
+
+            self.blob_image = Frame(
+                blob_image,
+                self._moving_foregrouned.moving_foreground.get_frame_number(),
+            )
+
         return StageResult(True, True)
@@ -8,15 +8,15 @@ from baboon_tracking.stages.motion_detector.apply_masks import ApplyMasks
 from baboon_tracking.stages.motion_detector.compute_moving_foreground import (
     ComputeMovingForeground,
 )
+from baboon_tracking.stages.motion_detector.compute_temporal_statistics import (
+    ComputeTemporalStatistics,
+)
 from baboon_tracking.stages.motion_detector.compute_transformation_matrices import (
     ComputeTransformationMatrices,
 )
-
-from baboon_tracking.stages.motion_detector.generate_mask_subcomponents.generate_mask_subcomponents import (
-    GenerateMaskSubcomponents,
+from baboon_tracking.stages.motion_detector.subtract_background import (
+    SubtractBackground,
 )
-from baboon_tracking.stages.motion_detector.generate_weights import GenerateWeights
-from baboon_tracking.stages.motion_detector.min_size_filter import MinSizeFilter
 from baboon_tracking.stages.motion_detector.noise_reduction.noise_reduction import (
     NoiseReduction,
 )
@@ -50,11 +50,10 @@ class MotionDetector(Serial):
             ComputeTransformationMatrices,
             TransformedFrames,
             QuantizeHistoryFrames,
-            GenerateWeights,
-            GenerateMaskSubcomponents,
+            ComputeTemporalStatistics,
+            SubtractBackground,
             ComputeMovingForeground,
             ApplyMasks,
             NoiseReduction,
             DetectBlobs,
-            MinSizeFilter,
         )
@@ -2,93 +2,71 @@
 Implements a group filter to ensure that all pixels are in a group at least size n.
 """
 
-from typing import Tuple
+import cv2
 import numpy as np
-from numba import jit, prange
 from baboon_tracking.decorators.show_result import show_result
 from baboon_tracking.mixins.moving_foreground_mixin import MovingForegroundMixin
 from baboon_tracking.models.frame import Frame
 from pipeline import Stage
-from pipeline.decorators import config, stage
+from pipeline.buffer_pool import BufferPool
+from pipeline.decorators import buffer_pool, config, stage
 from pipeline.stage_result import StageResult
 
 
-@jit(nopython=True)
-def _pixel_has_neighbors(moving_foreground, group_size: int, coord: Tuple[int, int]):
-    x_coord, y_coord = coord
-
-    height, width = moving_foreground.shape
-
-    if moving_foreground[y_coord, x_coord] == 0:
-        return False
-
-    min_x = max(x_coord - 1, 0)
-    max_x = min(x_coord + 1, width - 1)
-
-    min_y = max(y_coord - 1, 0)
-    max_y = min(y_coord + 1, height - 1)
-
-    count = 0
-    for y in range(min_y, max_y + 1):
-        for x in range(min_x, max_x + 1):
-            if y == y_coord and x == x_coord:
-                continue
-
-            if moving_foreground[y, x] > 0:
-                count += 1
-
-            if count >= group_size:
-                return True
-
-    return False
-
-
-@jit(nopython=True, parallel=True)
-# @cuda.jit()
-def _execute(
-    moving_foreground, curr_moving_foreground, group_size: int, height: int, width: int
-):
-    # pylint: disable=not-an-iterable
-    for y in prange(height):
-        for x in prange(width):
-            if _pixel_has_neighbors(curr_moving_foreground, group_size, (x, y),):
-                moving_foreground[y, x] = 255
+def _filter(curr_moving_foreground, group_size: int, binary, counts, moving_foreground):
+    """
+    Group filter built on a box filter, writing into the given buffers.
+    """
+    # Count the set pixels in every 3x3 window. A set pixel with at least
+    # group_size set neighbors has a window count of at least group_size + 1.
+    cv2.threshold(curr_moving_foreground, 0, 1, cv2.THRESH_BINARY, binary)
+    cv2.boxFilter(
+        binary, -1, (3, 3), counts, normalize=False, borderType=cv2.BORDER_CONSTANT
+    )
+    cv2.compare(counts, float(int(group_size) + 1), cv2.CMP_GE, moving_foreground)
+    cv2.multiply(moving_foreground, binary, moving_foreground)
 
 
 @show_result
 @config("group_size", "motion_detector/group_filter/size")
 @stage("moving_foreground")
+@buffer_pool("pool")
 class GroupFilter(Stage, MovingForegroundMixin):
     """
     Implements a group filter to ensure that all pixels are in a group at least size n.
     """
 
     def __init__(
-        self, group_size: int, moving_foreground: MovingForegroundMixin
+        self,
+        group_size: int,
+        moving_foreground: MovingForegroundMixin,
+        pool: BufferPool,
     ) -> None:
         Stage.__init__(self)
         MovingForegroundMixin.__init__(self)
 
         self._group_size = group_size
         self._moving_foreground = moving_foreground
+        self._pool = pool
 
-    def execute(self) -> StageResult:
-        moving_foreground = np.zeros_like(
-            self._moving_foreground.moving_foreground.get_frame()
-        )
-        height, width = moving_foreground.shape
+        self._binary = None
+        self._counts = None
 
-        _execute(
-            moving_foreground,
-            self._moving_foreground.moving_foreground.get_frame(),
-            self._group_size,
-            height,
-            width,
+    def execute(self) -> StageResult:
+        curr_moving_foreground = self._moving_foreground.moving_foreground.get_frame()
+        frame_number = self._moving_foreground.moving_foreground.get_frame_number()
+
+        # The scratch arrays never leave the stage, the output is handed on and
+        # comes from the pool.
+        if self._binary is None or self._binary.shape != curr_moving_foreground.shape:
+            self._binary = np.empty_like(curr_moving_foreground)
+            self._counts = np.empty_like(curr_moving_foreground)
+
+        output = self._pool.get_like(curr_moving_foreground)
+        _filter(
+            curr_moving_foreground, self._group_size, self._binary, self._counts, output
         )
 
-        self.moving_foreground = Frame(
-            moving_foreground,
-            self._moving_foreground.moving_foreground.get_frame_number(),
-        )
+        self.moving_foreground = Frame(output, frame_number)
 
         return StageResult(True, True)
@@ -2,14 +2,55 @@
 Implements a filter using Hysteriesis
 """
 import numpy as np
+from numba import jit, prange
 from baboon_tracking.decorators.show_result import show_result
 
 from baboon_tracking.models.frame import Frame
 from baboon_tracking.mixins.moving_foreground_mixin import MovingForegroundMixin
 from pipeline import Stage
-from pipeline.decorators import stage, config
+from pipeline.buffer_pool import BufferPool
+from pipeline.decorators import buffer_pool, stage, config
 from pipeline.stage_result import StageResult
 
+_MAX_OBSERVATIONS = 255
+
+
+@jit(nopython=True, parallel=True)
+def _execute(
+    moving_foreground,
+    motion_observations,
+    no_motion_observations,
+    result,
+    output,
+    required_motion_observations: int,
+    required_no_motion_observations: int,
+):
+    height, width = moving_foreground.shape
+
+    # pylint: disable=not-an-iterable
+    for y in prange(height):
+        for x in range(width):
+            value = moving_foreground[y, x]
+
+            # The counters saturate, so long stretches of motion can't wrap
+            # them around to a count that triggers again.
+            if value == 255:
+                if motion_observations[y, x] < _MAX_OBSERVATIONS:
+                    motion_observations[y, x] += 1
+                no_motion_observations[y, x] = 0
+            elif value == 0:
+                motion_observations[y, x] = 0
+                if no_motion_observations[y, x] < _MAX_OBSERVATIONS:
+                    no_motion_observations[y, x] += 1
+
+            if motion_observations[y, x] == required_motion_observations:
+                result[y, x] = 255
+
+            if no_motion_observations[y, x] == required_no_motion_observations:
+                result[y, x] = 0
+
+            output[y, x] = result[y, x]
+
 
 @show_result
 @config(
@@ -21,6 +62,7 @@ from pipeline.stage_result import StageResult
     key="motion_detector/hysteresis/required_no_motion_observations",
 )
 @stage("moving_foreground")
+@buffer_pool("pool")
 class HysteresisFilter(Stage, MovingForegroundMixin):
     """
     Implements a filter using Hysteriesis
@@ -31,6 +73,7 @@ class HysteresisFilter(Stage, MovingForegroundMixin):
         required_motion_observations: int,
         required_no_motion_observations: int,
         moving_foreground: MovingForegroundMixin,
+        pool: BufferPool,
     ) -> None:
         Stage.__init__(self)
         MovingForegroundMixin.__init__(self)
@@ -41,40 +84,30 @@ class HysteresisFilter(Stage, MovingForegroundMixin):
         self._required_motion_observations = required_motion_observations
         self._required_no_motion_observations = required_no_motion_observations
         self._moving_foreground = moving_foreground
+        self._pool = pool
 
     def execute(self) -> StageResult:
-        if self._result is None:
-            self._result = np.zeros_like(
-                self._moving_foreground.moving_foreground.get_frame()
-            )
-
-            self._motion_observations = np.zeros_like(
-                self._moving_foreground.moving_foreground.get_frame()
-            )
-
-            self._no_motion_observations = np.zeros_like(
-                self._moving_foreground.moving_foreground.get_frame()
-            )
-
-        mask = self._moving_foreground.moving_foreground.get_frame() == 255
-        not_mask = self._moving_foreground.moving_foreground.get_frame() == 0
+        moving_foreground = self._moving_foreground.moving_foreground.get_frame()
 
-        self._motion_observations[not_mask] = 0
-        self._motion_observations[mask] += 1
-
-        self._no_motion_observations[mask] = 0
-        self._no_motion_observations[not_mask] += 1
-
-        self._result[
-            self._motion_observations == self._required_motion_observations
-        ] = 255
+        if self._result is None:
+            self._result = np.zeros_like(moving_foreground)
+            self._motion_observations = np.zeros_like(moving_foreground)
+            self._no_motion_observations = np.zeros_like(moving_foreground)
 
-        self._result[
-            self._no_motion_observations == self._required_motion_observations
-        ] = 0
+        # The state is updated across frames, so the output is a copy of it.
+        output = self._pool.get_like(moving_foreground)
+        _execute(
+            moving_foreground,
+            self._motion_observations,
+            self._no_motion_observations,
+            self._result,
+            output,
+            self._required_motion_observations,
+            self._required_no_motion_observations,
+        )
 
         self.moving_foreground = Frame(
-            self._result, self._moving_foreground.moving_foreground.get_frame_number()
+            output, self._moving_foreground.moving_foreground.get_frame_number()
         )
 
         return StageResult(True, True)
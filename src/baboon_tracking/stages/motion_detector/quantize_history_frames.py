@@ -1,12 +1,14 @@
 """Quantizes the shifted history frame."""
 
+import cv2
 import numpy as np
 from baboon_tracking.mixins.shifted_history_frames_mixin import (
     ShiftedHistoryFramesMixin,
 )
 from baboon_tracking.models.frame import Frame
 from baboon_tracking.mixins.quantized_frames_mixin import QuantizedFramesMixin
-from pipeline.decorators import config, stage
+from pipeline.buffer_pool import BufferPool
+from pipeline.decorators import buffer_pool, config, stage
 from pipeline.stage import Stage
 from pipeline.stage_result import StageResult
 
@@ -15,26 +17,39 @@ from pipeline.stage_result import StageResult
     parameter_name="scale_factor", key="motion_detector/quantize_frames/scale_factor"
 )
 @stage("shifted_history_frames")
+@buffer_pool("pool")
 class QuantizeHistoryFrames(Stage, QuantizedFramesMixin):
     """Quantizes the shifted history frame."""
 
     def __init__(
-        self, scale_factor: float, shifted_history_frames: ShiftedHistoryFramesMixin
+        self,
+        scale_factor: float,
+        shifted_history_frames: ShiftedHistoryFramesMixin,
+        pool: BufferPool,
     ):
         QuantizedFramesMixin.__init__(self)
         Stage.__init__(self)
 
         self._scale_factor = scale_factor
         self._shifted_history_frames = shifted_history_frames
+        self._pool = pool
+
+        # Quantizing is a pure function of the pixel value, so compute it once
+        # for every value and look it up, keeping the quantized frames 8 bit.
+        self._lookup_table = np.floor(
+            np.arange(256, dtype=np.float32) * self._scale_factor / 255.0
+        ).astype(np.uint8)
 
     def _quantize_frame(self, frame: Frame):
         """
         Normalize pixel values from 0-255 to values from 0-self._scale_factor
         Returns quantized frame
         """
-        return np.floor(
-            frame.get_frame().astype(np.float32) * self._scale_factor / 255.0
-        ).astype(np.int32)
+        return cv2.LUT(
+            frame.get_frame(),
+            self._lookup_table,
+            dst=self._pool.get_like(frame.get_frame()),
+        )
 
     def execute(self) -> StageResult:
         """Quantizes the shifted history frame."""
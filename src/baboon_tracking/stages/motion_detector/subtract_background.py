@@ -8,7 +8,8 @@ from baboon_tracking.mixins.preprocessed_frame_mixin import PreprocessedFrameMix
 from baboon_tracking.mixins.unioned_frames_mixin import UnionedFramesMixin
 from baboon_tracking.mixins.weights_mixin import WeightsMixin
 from pipeline import Stage
-from pipeline.decorators import config, stage
+from pipeline.buffer_pool import BufferPool
+from pipeline.decorators import buffer_pool, config, stage
 from pipeline.stage_result import StageResult
 
 
@@ -16,6 +17,7 @@ from pipeline.stage_result import StageResult
 @stage("unioned_frames")
 @stage("weights")
 @config(parameter_name="history_frames", key="motion_detector/history_frames")
+@buffer_pool("pool")
 class SubtractBackground(Stage, ForegroundMixin):
     """
     Subtracts background representation from the frame.
@@ -27,6 +29,7 @@ class SubtractBackground(Stage, ForegroundMixin):
         unioned_frames: UnionedFramesMixin,
         weights: WeightsMixin,
         history_frames: int,
+        pool: BufferPool,
     ) -> None:
         Stage.__init__(self)
         ForegroundMixin.__init__(self)
@@ -35,28 +38,34 @@ class SubtractBackground(Stage, ForegroundMixin):
         self._unioned_frames = unioned_frames
         self._weights = weights
         self._history_frames = history_frames
+        self._pool = pool
 
     def execute(self) -> StageResult:
         frame = self._preprocessed_frame.processed_frame
         union = self._unioned_frames.unioned_frames
         weights = self._weights.weights
 
-        frame_new = self._zero_weights(frame.get_frame(), weights)
-        union_new = self._zero_weights(union, weights)
+        foreground = cv2.absdiff(
+            frame.get_frame(), union, dst=self._pool.get_like(union)
+        )
+        cv2.bitwise_and(foreground, self._get_changing(weights), dst=foreground)
 
-        self.foreground = cv2.absdiff(frame_new, union_new)
+        self.foreground = foreground
 
         return StageResult(True, True)
 
-    def _zero_weights(self, frame, weights):
+    def _get_changing(self, weights):
         """
-        Gets foreground of frame by zeroing out all pixels with large weights,
+        Gets a mask that zeroes out all pixels with large weights,
         i.e. pixels in which frequency of commonality
         is really high, meaning that it hasn't changed much or at all in the
-        history frames, according to figure 13 of paper
-        Returns frame representing the foreground
+        history frames, according to figure 13 of paper.
+        Zeroing those pixels in the frame and the union before taking their
+        difference is the same as zeroing them in the difference.
         """
-        f = frame.copy()
-        f[weights >= self._history_frames - 1] = 0
-
-        return f
+        return cv2.compare(
+            weights,
+            float(self._history_frames - 1),
+            cv2.CMP_LT,
+            dst=self._pool.get_like(weights),
+        )
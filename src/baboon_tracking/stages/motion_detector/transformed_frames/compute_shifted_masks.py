@@ -9,13 +9,64 @@ from baboon_tracking.mixins.shifted_masks_mixin import ShiftedMasksMixin
 from baboon_tracking.mixins.transformation_matrices_mixin import (
     TransformationMatricesMixin,
 )
-from pipeline.decorators import stage
+from pipeline.buffer_pool import BufferPool
+from pipeline.decorators import buffer_pool, stage
 from pipeline.stage import Stage
 from pipeline.stage_result import StageResult
 
+# Number of fractional bits used when rasterizing the valid region.
+_SHIFT = 8
+
+
+def _clip(polygon, convex):
+    """
+    Clips polygon to the convex polygon using Sutherland-Hodgman.
+    """
+    # Orient the edges so the inside of convex is always to their left.
+    x, y = convex[:, 0], convex[:, 1]
+    if np.dot(x, np.roll(y, -1)) - np.dot(y, np.roll(x, -1)) < 0:
+        convex = convex[::-1]
+
+    for start, end in zip(convex, np.roll(convex, -1, axis=0)):
+        if len(polygon) == 0:
+            break
+
+        edge = end - start
+        sides = edge[0] * (polygon[:, 1] - start[1]) - edge[1] * (
+            polygon[:, 0] - start[0]
+        )
+
+        clipped = []
+        for i, point in enumerate(polygon):
+            previous_side = sides[i - 1]
+            if (sides[i] >= 0) != (previous_side >= 0):
+                t = previous_side / (previous_side - sides[i])
+                clipped.append(polygon[i - 1] + t * (point - polygon[i - 1]))
+            if sides[i] >= 0:
+                clipped.append(point)
+
+        polygon = np.array(clipped).reshape(-1, 2)
+
+    return polygon
+
+
+def _warp_valid(shifted_mask, transformation_matrices):
+    """
+    ANDs the frame warped by each of the transformation matrices into shifted_mask.
+    """
+    height, width = shifted_mask.shape
+    valid = np.full((height, width), 255, dtype=np.uint8)
+    for M in transformation_matrices:
+        cv2.bitwise_and(
+            shifted_mask,
+            cv2.warpPerspective(valid, M, (width, height), flags=cv2.INTER_NEAREST),
+            dst=shifted_mask,
+        )
+
 
 @stage("transformation_matrices")
 @stage("frame")
+@buffer_pool("pool")
 class ComputeShiftedMasks(Stage, ShiftedMasksMixin):
     """
     Compute shifted masks for use in throwing pixels not common between frames.
@@ -25,23 +76,53 @@ class ComputeShiftedMasks(Stage, ShiftedMasksMixin):
         self,
         transformation_matrices: TransformationMatricesMixin,
         frame: PreprocessedFrameMixin,
+        pool: BufferPool,
     ):
         ShiftedMasksMixin.__init__(self)
         Stage.__init__(self)
 
         self._transformation_matrices = transformation_matrices
         self._frame = frame
+        self._pool = pool
 
     def execute(self) -> StageResult:
         transformation_matrices = self._transformation_matrices.transformation_matrices
         frame = self._frame.processed_frame
 
-        img = np.ones(frame.get_frame().shape).astype(np.uint8)
-        self.shifted_masks = [
-            cv2.warpPerspective(
-                img, M, (frame.get_frame().shape[1], frame.get_frame().shape[0]),
+        height, width = frame.get_frame().shape[:2]
+        corners = np.array(
+            [[[0, 0]], [[width - 1, 0]], [[width - 1, height - 1]], [[0, height - 1]]],
+            dtype=np.float32,
+        )
+
+        # Every warped history frame covers the convex quadrilateral its
+        # corners are projected to, so intersect those instead of warping images.
+        frame_corners = corners.reshape(-1, 2).astype(np.float64)
+        region = frame_corners
+        degenerate = []
+        for M in transformation_matrices:
+            # If w changes sign over the frame, part of it is projected through
+            # infinity and the warped frame is not the quad of its corners.
+            w = frame_corners @ M[2, :2] + M[2, 2]
+            if not (np.all(w > 0) or np.all(w < 0)):
+                degenerate.append(M)
+                continue
+
+            projected = cv2.perspectiveTransform(corners, M).reshape(-1, 2)
+            region = _clip(region, projected.astype(np.float64))
+
+        self.shifted_mask = self._pool.get((height, width), np.uint8)
+        self.shifted_mask.fill(0)
+        if len(region) >= 3:
+            cv2.fillConvexPoly(
+                self.shifted_mask,
+                np.round(region * (1 << _SHIFT)).astype(np.int32),
+                255,
+                shift=_SHIFT,
             )
-            for M in transformation_matrices
-        ]
+
+        # Such homographies are rare, so warp the frame for them like before.
+        if degenerate:
+            _warp_valid(self.shifted_mask, degenerate)
 
         return StageResult(True, True)
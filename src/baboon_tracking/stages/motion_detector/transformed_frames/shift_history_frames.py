@@ -2,7 +2,6 @@
 Implements a stage which shifts history frames.
 """
 import cv2
-import numpy as np
 from baboon_tracking.mixins.history_frames_mixin import HistoryFramesMixin
 from baboon_tracking.mixins.shifted_history_frames_mixin import (
     ShiftedHistoryFramesMixin,
@@ -11,13 +10,15 @@ from baboon_tracking.mixins.transformation_matrices_mixin import (
     TransformationMatricesMixin,
 )
 from baboon_tracking.models.frame import Frame
-from pipeline.decorators import stage
+from pipeline.buffer_pool import BufferPool
+from pipeline.decorators import buffer_pool, stage
 from pipeline.stage import Stage
 from pipeline.stage_result import StageResult
 
 
 @stage("transformation_matrices")
 @stage("history_frames")
+@buffer_pool("pool")
 class ShiftHistoryFrames(Stage, ShiftedHistoryFramesMixin):
     """
     Implements a stage which shifts history frames.
@@ -27,12 +28,14 @@ class ShiftHistoryFrames(Stage, ShiftedHistoryFramesMixin):
         self,
         history_frames: HistoryFramesMixin,
         transformation_matrices: TransformationMatricesMixin,
+        pool: BufferPool,
     ):
         ShiftedHistoryFramesMixin.__init__(self)
         Stage.__init__(self)
 
         self._history_frames = history_frames
         self._transformation_matrices = transformation_matrices
+        self._pool = pool
 
     def execute(self) -> StageResult:
         """
@@ -52,7 +55,8 @@ class ShiftHistoryFrames(Stage, ShiftedHistoryFramesMixin):
                         history_frame.get_frame().shape[1],
                         history_frame.get_frame().shape[0],
                     ),
-                ).astype(np.uint8),
+                    dst=self._pool.get_like(history_frame.get_frame()),
+                ),
                 history_frame.get_frame_number(),
             )
             for history_frame, M in zip(history_frames, transformation_matrices)
@@ -31,6 +31,7 @@ class BlurGray(Stage, PreprocessedFrameMixin):
         Blurs a gray frame using a Gaussian blur.
         """
 
+        # The history keeps the blurred frame for later frames, so it is not pooled.
         self.processed_frame = Frame(
             cv2.GaussianBlur(
                 self._preprocessed_frame.processed_frame.get_frame(),
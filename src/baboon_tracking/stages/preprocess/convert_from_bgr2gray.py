@@ -2,34 +2,50 @@
 Converts a color image to a gray-scale image.
 """
 import cv2
+import numpy as np
 from baboon_tracking.mixins.frame_mixin import FrameMixin
 from baboon_tracking.models.frame import Frame
+from baboon_tracking.models.luma_frame import LumaFrame
 from baboon_tracking.mixins.preprocessed_frame_mixin import PreprocessedFrameMixin
 
 from pipeline import Stage
-from pipeline.decorators import stage
+from pipeline.buffer_pool import BufferPool
+from pipeline.decorators import buffer_pool, stage
 from pipeline.stage_result import StageResult
 
 
 @stage("frame_mixin")
+@buffer_pool("pool")
 class ConvertFromBGR2Gray(Stage, PreprocessedFrameMixin):
     """
     Converts a color image to a gray-scale image.
     """
 
-    def __init__(self, frame_mixin: FrameMixin):
+    def __init__(self, frame_mixin: FrameMixin, pool: BufferPool):
         PreprocessedFrameMixin.__init__(self)
         Stage.__init__(self)
 
         self._frame_mixin = frame_mixin
+        self._pool = pool
 
     def execute(self) -> StageResult:
         """
         Converts a color image to a gray-scale image.
         """
 
+        frame = self._frame_mixin.frame
+
+        # Frames decoded as luma are already gray.
+        if isinstance(frame, LumaFrame):
+            self.processed_frame = Frame(frame.get_luma(), frame.get_frame_number())
+            return StageResult(True, True)
+
         self.processed_frame = Frame(
-            cv2.cvtColor(self._frame_mixin.frame.get_frame(), cv2.COLOR_BGR2GRAY),
-            self._frame_mixin.frame.get_frame_number(),
+            cv2.cvtColor(
+                frame.get_frame(),
+                cv2.COLOR_BGR2GRAY,
+                dst=self._pool.get(frame.get_frame().shape[:2], np.uint8),
+            ),
+            frame.get_frame_number(),
         )
         return StageResult(True, True)
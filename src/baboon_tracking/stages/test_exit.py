@@ -1,27 +1,48 @@
 """
-Tests for the press of the "Q" key or the end of the video.
+Tests for a stop request, the press of the "Q" key or the end of the video.
 """
+from typing import Dict
 
 import cv2
 
+from library.display import has_display, show_pending
+from library.stop_request import STOP_REQUEST
 from pipeline import Stage
+from pipeline.decorators import main_thread, runtime_config
 from pipeline.stage_result import StageResult
 
 
+@main_thread
+@runtime_config("rconfig")
 class TestExit(Stage):
     """
-    Tests for the press of the "Q" key or the end of the video.
+    Tests for a stop request, the press of the "Q" key or the end of the video.
     """
 
-    def __init__(self) -> None:
+    def __init__(self, rconfig: Dict[str, any]) -> None:
         Stage.__init__(self)
 
+        # Only poll the keyboard when show_result has opened windows.
+        display = "display" not in rconfig or rconfig["display"]
+        self._poll_keyboard = display and has_display()
+
+    def on_init(self) -> None:
+        STOP_REQUEST.install()
+
     def execute(self) -> StageResult:
         """
-        Tests for the press of the "Q" key or the end of the video.
+        Tests for a stop request, the press of the "Q" key or the end of the video.
         """
 
-        if cv2.waitKey(25) & 0xFF == ord("q"):
+        if STOP_REQUEST.is_requested():
+            return StageResult(False, None)
+
+        if not self._poll_keyboard:
+            return StageResult(True, True)
+
+        show_pending()
+
+        if cv2.waitKey(1) & 0xFF == ord("q"):
             return StageResult(False, None)
 
         return StageResult(True, True)
@@ -0,0 +1,310 @@
+"""
+Times optimized building blocks against the implementations they replace.
+"""
+from argparse import ArgumentParser, Namespace
+import time
+from types import SimpleNamespace
+from typing import Tuple
+import cv2
+import numpy as np
+from numba import jit, prange
+from cli_plugins.cli_plugin import CliPlugin
+
+
+def _read_frame(video_path: str, width: int, height: int):
+    capture = cv2.VideoCapture(video_path)
+    success, frame = capture.read()
+    capture.release()
+
+    if not success:
+        raise ValueError("Could not read a frame from " + video_path)
+
+    if frame.shape[:2] != (height, width):
+        frame = cv2.resize(frame, (width, height), interpolation=cv2.INTER_CUBIC)
+
+    return cv2.cvtColor(frame, cv2.COLOR_BGR2GRAY)
+
+
+def _time(function, repeat: int):
+    function()
+
+    start = time.perf_counter()
+    for _ in range(repeat):
+        function()
+
+    return (time.perf_counter() - start) * 1000 / repeat
+
+
+def _get_mask(frame):
+    # Pixels that change under a small shift look like a sparse moving foreground.
+    mask = cv2.absdiff(frame, np.roll(frame, 2, axis=1))
+    _, mask = cv2.threshold(mask, 20, 255, cv2.THRESH_BINARY)
+
+    return mask
+
+
+def _benchmark_ssc(args: Namespace, frame):
+    # pylint: disable=import-outside-toplevel
+    from config import get_config_part
+    from library.ssc import pack_keypoints, select_keypoints
+    from third_party.ssc import ssc as reference_ssc
+
+    keypoints = cv2.FastFeatureDetector_create().detect(frame, None)
+
+    num_ret_points = get_config_part("motion_detector/registration/ssc_num_ret_points")
+    tolerance = get_config_part("motion_detector/registration/ssc_tolerence")
+    height, width = frame.shape
+
+    # Both sides select among the keypoints ordered by response, like ComputeTransformationMatrices.
+    def reference():
+        return reference_ssc(
+            sorted(keypoints, key=lambda k: k.response, reverse=True),
+            num_ret_points,
+            tolerance,
+            width,
+            height,
+        )
+
+    def select():
+        return select_keypoints(keypoints, num_ret_points, tolerance, width, height)
+
+    selected = select()
+
+    print(str(len(keypoints)) + " keypoints, " + str(len(selected)) + " selected")
+    print("Matches reference: " + str([keypoints[i] for i in selected] == reference()))
+    print("third_party.ssc with sorting: %.2f ms" % _time(reference, args.repeat))
+    print("library.ssc with packing and sorting: %.2f ms" % _time(select, args.repeat))
+    print(
+        "library.ssc packing only: %.2f ms"
+        % _time(lambda: pack_keypoints(keypoints), args.repeat)
+    )
+
+
+@jit(nopython=True)
+def _reference_pixel_has_neighbors(
+    moving_foreground, group_size: int, coord: Tuple[int, int]
+):
+    x_coord, y_coord = coord
+
+    height, width = moving_foreground.shape
+
+    if moving_foreground[y_coord, x_coord] == 0:
+        return False
+
+    min_x = max(x_coord - 1, 0)
+    max_x = min(x_coord + 1, width - 1)
+
+    min_y = max(y_coord - 1, 0)
+    max_y = min(y_coord + 1, height - 1)
+
+    count = 0
+    for y in range(min_y, max_y + 1):
+        for x in range(min_x, max_x + 1):
+            if y == y_coord and x == x_coord:
+                continue
+
+            if moving_foreground[y, x] > 0:
+                count += 1
+
+            if count >= group_size:
+                return True
+
+    return False
+
+
+@jit(nopython=True, parallel=True)
+def _reference_group_filter(
+    moving_foreground, curr_moving_foreground, group_size: int, height: int, width: int
+):
+    """
+    Per pixel group filter that GroupFilter used before the box filter.
+    """
+    # pylint: disable=not-an-iterable
+    for y in prange(height):
+        for x in prange(width):
+            if _reference_pixel_has_neighbors(
+                curr_moving_foreground, group_size, (x, y)
+            ):
+                moving_foreground[y, x] = 255
+
+
+def _benchmark_group_filter(args: Namespace, frame):
+    # pylint: disable=import-outside-toplevel
+    from config import get_config_part
+    from baboon_tracking.stages.motion_detector.noise_reduction.group_filter import (
+        _filter,
+    )
+
+    mask = _get_mask(frame)
+    group_size = get_config_part("motion_detector/group_filter/size")
+    height, width = mask.shape
+
+    def reference():
+        output = np.zeros_like(mask)
+        _reference_group_filter(output, mask, group_size, height, width)
+
+        return output
+
+    binary = np.empty_like(mask)
+    counts = np.empty_like(mask)
+    output = np.empty_like(mask)
+
+    _filter(mask, group_size, binary, counts, output)
+
+    print(str(np.count_nonzero(mask)) + " set pixels")
+    print("Matches reference: " + str(np.array_equal(reference(), output)))
+    print("numba kernel: %.2f ms" % _time(reference, args.repeat))
+    print(
+        "box filter: %.2f ms"
+        % _time(lambda: _filter(mask, group_size, binary, counts, output), args.repeat)
+    )
+
+
+def _benchmark_morphology(args: Namespace, frame):
+    # pylint: disable=import-outside-toplevel
+    from config import get_config_part
+    from library import morphology
+
+    mask = _get_mask(frame)
+
+    # The configured sizes, and larger ones to show how the costs scale.
+    kernel_sizes = {
+        get_config_part("motion_detector/noise_reduction/" + key)
+        for key in ["erode_kernel_size", "dilate_kernel_size", "combine_kernel_size"]
+    }
+
+    for kernel_size in sorted(kernel_sizes | {48, 96}):
+        element = cv2.getStructuringElement(
+            cv2.MORPH_ELLIPSE, (kernel_size, kernel_size)
+        )
+
+        for name, ellipse, octagon in [
+            ("dilate", cv2.dilate, morphology.dilate),
+            ("erode", cv2.erode, morphology.erode),
+        ]:
+            difference = np.count_nonzero(
+                ellipse(mask, element) != octagon(mask, kernel_size)
+            )
+
+            print(
+                "%s %d: %.3f%% of pixels differ, ellipse %.2f ms, octagon %.2f ms"
+                % (
+                    name,
+                    kernel_size,
+                    difference * 100 / mask.size,
+                    _time(lambda: ellipse(mask, element), args.repeat),
+                    _time(lambda: octagon(mask, kernel_size), args.repeat),
+                )
+            )
+
+
+def _benchmark_detect_blobs(args: Namespace, frame):
+    # pylint: disable=import-outside-toplevel
+    from config import get_config_part
+    from baboon_tracking.models.baboon import Baboon
+    from baboon_tracking.models.frame import Frame
+    from baboon_tracking.stages.motion_detector.detect_blobs import DetectBlobs
+
+    min_size = get_config_part("motion_detector/min_size_filter/min_size")
+    crowded = cv2.dilate(_get_mask(frame), np.ones((3, 3), dtype=np.uint8))
+    # Opening leaves the larger blobs, closer to a mask after noise reduction.
+    sparse = cv2.morphologyEx(
+        crowded,
+        cv2.MORPH_OPEN,
+        cv2.getStructuringElement(cv2.MORPH_ELLIPSE, (9, 9)),
+    )
+
+    def time_mask(name: str, mask):
+        # DetectBlobs followed by MinSizeFilter, as before connected components.
+        def contours():
+            found, _ = cv2.findContours(mask, cv2.RETR_LIST, cv2.CHAIN_APPROX_SIMPLE)
+            baboons = [
+                Baboon((x, y, x + w, y + h))
+                for x, y, w, h in [cv2.boundingRect(c) for c in found]
+            ]
+
+            return [
+                b
+                for b in baboons
+                if float(b.rectangle[2] - b.rectangle[0])
+                * float(b.rectangle[3] - b.rectangle[1])
+                >= min_size
+            ]
+
+        detect_blobs = DetectBlobs(
+            min_size, SimpleNamespace(moving_foreground=Frame(mask, 0)), {}
+        )
+        detect_blobs.show_result_set_runtime_config({"display": False})
+
+        def components():
+            detect_blobs.execute()
+
+            return detect_blobs.baboons
+
+        print(
+            "%s: %d contours kept, %d components kept"
+            % (name, len(contours()), len(components()))
+        )
+        print("findContours and boundingRect: %.2f ms" % _time(contours, args.repeat))
+        print(
+            "connectedComponentsWithStats on the whole frame: %.2f ms"
+            % _time(
+                lambda: cv2.connectedComponentsWithStatsWithAlgorithm(
+                    mask, 8, cv2.CV_32S, cv2.CCL_GRANA
+                ),
+                args.repeat,
+            )
+        )
+        print("DetectBlobs: %.2f ms" % _time(components, args.repeat))
+
+    time_mask("crowded", crowded)
+    time_mask("sparse", sparse)
+
+
+benchmarks = {
+    "ssc": _benchmark_ssc,
+    "group_filter": _benchmark_group_filter,
+    "morphology": _benchmark_morphology,
+    "detect_blobs": _benchmark_detect_blobs,
+}
+
+
+class Benchmark(CliPlugin):
+    """
+    Times optimized building blocks against the implementations they replace.
+    """
+
+    def __init__(self, parser: ArgumentParser):
+        CliPlugin.__init__(self, parser)
+
+        parser.add_argument(
+            "benchmark", type=str, choices=benchmarks.keys(), help="Benchmark to run"
+        )
+
+        parser.add_argument(
+            "-v",
+            "--video",
+            type=str,
+            default="./data/input.mp4",
+            help="Video to take the benchmark frame from",
+        )
+
+        parser.add_argument(
+            "-s",
+            "--sizes",
+            type=str,
+            nargs="+",
+            default=["1920x1080", "3840x2160"],
+            help="Sizes (WIDTHxHEIGHT) the benchmark frame is resized to",
+        )
+
+        parser.add_argument(
+            "-r", "--repeat", type=int, default=10, help="Number of timed repetitions"
+        )
+
+    def execute(self, args: Namespace):
+        for size in args.sizes:
+            width, height = (int(s) for s in size.split("x"))
+
+            print(size + ":")
+            benchmarks[args.benchmark](args, _read_frame(args.video, width, height))
@@ -3,7 +3,7 @@ Generates a chart representing the baboon tracking algorithm.
 """
 from argparse import ArgumentParser, Namespace
 from baboon_tracking import BaboonTracker
-from baboon_tracking.preset_pipelines import preset_pipelines
+from baboon_tracking.preset_pipelines import executions, preset_pipelines
 from cli_plugins.cli_plugin import CliPlugin
 
 
@@ -24,5 +24,18 @@ class Chart(CliPlugin):
             help="Preset pipeline to run",
         )
 
+        parser.add_argument(
+            "-e",
+            "--execution",
+            type=str,
+            choices=executions.keys(),
+            default="serial",
+            help="Chart the stages in execution order or as a dependency graph.",
+        )
+
     def execute(self, args: Namespace):
-        BaboonTracker(args.pipeline_name).flowchart().show()
+        runtime_config = {"execution": args.execution}
+
+        BaboonTracker(
+            args.pipeline_name, runtime_config=runtime_config
+        ).flowchart().show()
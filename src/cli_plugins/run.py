@@ -4,7 +4,7 @@ Starts the baboon tracker algorithm.
 from argparse import ArgumentParser, Namespace
 import argparse
 from baboon_tracking import BaboonTracker
-from baboon_tracking.preset_pipelines import preset_pipelines
+from baboon_tracking.preset_pipelines import executions, preset_pipelines
 from cli_plugins.cli_plugin import CliPlugin  # pylint: disable=import-outside-toplevel
 
 
@@ -55,7 +55,109 @@ class Run(CliPlugin):
             help="Indicates if should save results.",
         )
 
+        parser.add_argument(
+            "-p",
+            "--parallel",
+            type=str2bool,
+            default="yes",
+            help="Indicates if parallel stages should execute concurrently.",
+        )
+
+        parser.add_argument(
+            "-e",
+            "--execution",
+            type=str,
+            choices=executions.keys(),
+            default="serial",
+            help="Execute the stages serially, pipelined across frames or as a dependency graph.",
+        )
+
+        parser.add_argument(
+            "--read_ahead",
+            type=int,
+            default=0,
+            help="Number of frames decoded ahead on a background thread.  0 decodes synchronously.",
+        )
+
+        parser.add_argument(
+            "--luma",
+            type=str2bool,
+            default="no",
+            help="Indicates if only the luma plane should be decoded.  Saved and displayed regions are gray.",
+        )
+
+        parser.add_argument(
+            "--luma_range",
+            type=str,
+            default="limited",
+            choices=["limited", "full"],
+            help="Range of the luma plane of the video.  Limited range luma is stretched to 0-255.",
+        )
+
+        parser.add_argument(
+            "--pipeline_depth",
+            type=int,
+            default=2,
+            help="Number of frames that can wait between pipelined stages.",
+        )
+
+        parser.add_argument(
+            "--graph_workers",
+            type=int,
+            default=0,
+            help="Number of threads the graph execution runs stages on.  0 uses one per CPU.",
+        )
+
+        parser.add_argument(
+            "--timing_interval",
+            type=int,
+            default=0,
+            help="Prints the latency percentiles of every stage each time this many frames are processed.  0 prints them only at the end.",
+        )
+
+        parser.add_argument(
+            "--trace",
+            type=str,
+            default="",
+            help="Writes every stage execution to this Chrome trace event file, viewable in chrome://tracing or Perfetto.",
+        )
+
+        parser.add_argument(
+            "--telemetry",
+            type=str,
+            default="",
+            help="Writes the counters published by the stages to this file, one JSON line per frame.  Counters published outside of a frame end up on a last line with a null frame.",
+        )
+
+        parser.add_argument(
+            "--track_store",
+            type=str,
+            default="",
+            help="Keeps the tracked baboons of every frame in this file, readable with library.track_store.load.  By default they are spilled to a temporary file that is deleted at the end.",
+        )
+
+        parser.add_argument(
+            "--memory",
+            action="store_true",
+            help="Reports the bytes allocated, the peak resident set size growth and the numpy arrays left alive per stage execution.  Tracing allocations slows the run down.",
+        )
+
     def execute(self, args: Namespace):
-        runtime_config = {"display": args.display, "save": args.save}
+        runtime_config = {
+            "display": args.display,
+            "save": args.save,
+            "parallel": args.parallel,
+            "execution": args.execution,
+            "pipeline_depth": args.pipeline_depth,
+            "graph_workers": args.graph_workers,
+            "read_ahead": args.read_ahead,
+            "luma": args.luma,
+            "luma_range": args.luma_range,
+            "timing_interval": args.timing_interval,
+            "trace": args.trace,
+            "telemetry": args.telemetry,
+            "memory": args.memory,
+            "track_store": args.track_store,
+        }
 
         BaboonTracker(args.pipeline_name, runtime_config=runtime_config).run()
@@ -0,0 +1,45 @@
+"""
+Module for showing images from any thread of the pipeline.
+"""
+import os
+import sys
+import threading
+from typing import Dict
+
+import cv2
+import numpy as np
+
+_lock = threading.Lock()
+_pending: Dict[str, np.ndarray] = {}
+
+
+def has_display() -> bool:
+    """
+    Tests if windows can be opened.  Only X11 needs the DISPLAY variable, other platforms always have a display.
+    """
+    return not sys.platform.startswith("linux") or os.environ.get("DISPLAY", "") != ""
+
+
+def show(window_name: str, image: np.ndarray):
+    """
+    Shows the image in the named window.  HighGUI only works on the main
+    thread, so images from other threads wait there until show_pending is called.
+    """
+    if threading.current_thread() is threading.main_thread():
+        cv2.imshow(window_name, image)
+        return
+
+    with _lock:
+        _pending[window_name] = image
+
+
+def show_pending():
+    """
+    Shows the latest image sent to each window from other threads.  Must be called from the main thread.
+    """
+    with _lock:
+        pending = list(_pending.items())
+        _pending.clear()
+
+    for window_name, image in pending:
+        cv2.imshow(window_name, image)
@@ -0,0 +1,75 @@
+"""
+Binary dilation and erosion by an octagon approximating the MORPH_ELLIPSE disk.
+
+The octagon is the Minkowski sum of a square and the two diagonal line
+segments. OpenCV dilates by each of those with a max per element along the
+segment, so the cost still grows linearly with the kernel size, but not with
+its area like that of a MORPH_ELLIPSE element.
+"""
+
+from functools import lru_cache
+import cv2
+import numpy as np
+
+
+def _dilate_octagon(mask, square_radius: int, diagonal_radius: int, even: bool):
+    if square_radius > 0:
+        size = 2 * square_radius + 1
+        mask = cv2.dilate(mask, np.ones((size, size), dtype=np.uint8))
+
+    if diagonal_radius > 0:
+        diagonal = np.eye(2 * diagonal_radius + 1, dtype=np.uint8)
+        mask = cv2.dilate(mask, diagonal)
+        mask = cv2.dilate(mask, np.fliplr(diagonal))
+
+    # Even sized ellipses reach one pixel further on one side, because the
+    # anchor of the MORPH_ELLIPSE element is right of and below its center.
+    if even:
+        mask = cv2.dilate(mask, np.ones((2, 2), dtype=np.uint8), anchor=(1, 1))
+
+    return mask
+
+
+@lru_cache(maxsize=None)
+def _get_octagon(kernel_size: int):
+    """
+    Finds the octagon closest to the MORPH_ELLIPSE element of the kernel size.
+    """
+    if kernel_size <= 1:
+        return 0, 0, False
+
+    size = 2 * kernel_size + 1
+    point = np.zeros((size, size), dtype=np.uint8)
+    point[kernel_size, kernel_size] = 255
+
+    even = kernel_size % 2 == 0
+    target = cv2.dilate(
+        point, cv2.getStructuringElement(cv2.MORPH_ELLIPSE, (kernel_size, kernel_size))
+    )
+
+    best = None
+    for square_radius in range(kernel_size // 2 + 1):
+        for diagonal_radius in range(kernel_size // 2 + 1):
+            octagon = _dilate_octagon(point, square_radius, diagonal_radius, even)
+            error = np.count_nonzero(octagon != target)
+
+            if best is None or error < best[0]:
+                best = (error, square_radius, diagonal_radius)
+
+    return best[1], best[2], even
+
+
+def dilate(mask, kernel_size: int):
+    """
+    Dilates the 0/255 mask by the octagon approximating an ellipse of kernel_size.
+    """
+    return _dilate_octagon(mask, *_get_octagon(kernel_size))
+
+
+def erode(mask, kernel_size: int):
+    """
+    Erodes the 0/255 mask by the octagon approximating an ellipse of kernel_size.
+    """
+    inverse = cv2.compare(mask, 0, cv2.CMP_EQ)
+
+    return cv2.compare(dilate(inverse, kernel_size), 0, cv2.CMP_EQ)
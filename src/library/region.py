@@ -3,6 +3,7 @@ Module for interacting with regions.
 """
 
 from typing import Tuple
+import numpy as np
 
 
 def bb_intersection_over_union(
@@ -30,6 +31,27 @@ def bb_intersection_over_union(
     return iou
 
 
+def bb_intersection_over_union_arrays(boxes_a: np.ndarray, boxes_b: np.ndarray):
+    """
+    Calculate the intersect over union of each row of boxes_a with the same row of boxes_b
+    """
+    x_a = np.maximum(boxes_a[:, 0], boxes_b[:, 0])
+    y_a = np.maximum(boxes_a[:, 1], boxes_b[:, 1])
+    x_b = np.minimum(boxes_a[:, 2], boxes_b[:, 2])
+    y_b = np.minimum(boxes_a[:, 3], boxes_b[:, 3])
+
+    inter_area = np.maximum(0, x_b - x_a + 1) * np.maximum(0, y_b - y_a + 1)
+
+    box_a_area = (boxes_a[:, 2] - boxes_a[:, 0] + 1) * (
+        boxes_a[:, 3] - boxes_a[:, 1] + 1
+    )
+    box_b_area = (boxes_b[:, 2] - boxes_b[:, 0] + 1) * (
+        boxes_b[:, 3] - boxes_b[:, 1] + 1
+    )
+
+    return inter_area / (box_a_area + box_b_area - inter_area).astype(np.float64)
+
+
 def check_if_same_region(
     region_1: Tuple[int, int, int, int], region_2: Tuple[int, int, int, int]
 ):
@@ -0,0 +1,129 @@
+"""
+Suppression via square covering (SSC) keypoint selection compiled with numba.
+
+Runs the same search as third_party/ssc.py, but on a packed array of
+keypoints instead of a list of OpenCV keypoints.
+"""
+
+import math
+import cv2
+import numpy as np
+from numba import jit
+
+
+def pack_keypoints(keypoints) -> np.ndarray:
+    """
+    Packs OpenCV keypoints into an (n, 3) float32 array of x, y and response.
+    """
+    packed = np.empty((len(keypoints), 3), dtype=np.float32)
+    if not keypoints:
+        return packed
+
+    packed[:, :2] = cv2.KeyPoint_convert(keypoints)
+    packed[:, 2] = [k.response for k in keypoints]
+
+    return packed
+
+
+@jit(nopython=True)
+def _select(points, low, high, k_min, k_max, cols, rows):
+    prev_width = -1.0
+    result = np.empty(0, dtype=np.int64)
+
+    while True:
+        width = low + (high - low) / 2
+        if width == prev_width or low > high:
+            # Return the keypoints from the previous iteration
+            return result
+
+        if width <= 0:
+            # Squares of no size only cover their own keypoint, so every one is kept
+            return np.arange(points.shape[0])
+
+        c = width / 2
+        num_cell_cols = int(math.floor(cols / c))
+        num_cell_rows = int(math.floor(rows / c))
+        reach = int(math.floor(width / c))
+        covered = np.zeros((num_cell_rows + 1, num_cell_cols + 1), dtype=np.bool_)
+
+        result = np.empty(points.shape[0], dtype=np.int64)
+        count = 0
+        for i in range(points.shape[0]):
+            row = int(math.floor(points[i, 1] / c))
+            col = int(math.floor(points[i, 0] / c))
+            if covered[row, col]:
+                continue
+
+            result[count] = i
+            count += 1
+
+            row_min = max(row - reach, 0)
+            row_max = min(row + reach, num_cell_rows)
+            col_min = max(col - reach, 0)
+            col_max = min(col + reach, num_cell_cols)
+            covered[row_min : row_max + 1, col_min : col_max + 1] = True
+
+        result = result[:count]
+
+        if k_min <= count <= k_max:
+            return result
+
+        if count < k_min:
+            high = width - 1
+        else:
+            low = width + 1
+        prev_width = width
+
+
+def ssc(
+    points: np.ndarray, num_ret_points: int, tolerance: float, cols: int, rows: int
+) -> np.ndarray:
+    """
+    Selects roughly num_ret_points spatially distributed keypoints, preferring
+    the ones that come first in points. Returns the indices of the selected rows.
+    """
+    if num_ret_points < 1 or not len(points):
+        return np.empty(0, dtype=np.int64)
+
+    exp1 = rows + cols + 2 * num_ret_points
+    exp2 = (
+        4 * cols
+        + 4 * num_ret_points
+        + 4 * rows * num_ret_points
+        + rows * rows
+        + cols * cols
+        - 2 * rows * cols
+        + 4 * rows * cols * num_ret_points
+    )
+    exp3 = math.sqrt(exp2)
+    exp4 = num_ret_points - 1
+
+    # A single square covering the whole frame bounds the search for one point.
+    if exp4 == 0:
+        high = max(cols, rows)
+    else:
+        sol1 = -round(float(exp1 + exp3) / exp4)
+        sol2 = -round(float(exp1 - exp3) / exp4)
+
+        high = max(sol1, sol2)
+    low = math.floor(math.sqrt(len(points) / num_ret_points))
+
+    k_min = round(num_ret_points - (num_ret_points * tolerance))
+    k_max = round(num_ret_points + (num_ret_points * tolerance))
+
+    return _select(points, float(low), float(high), k_min, k_max, cols, rows)
+
+
+def select_keypoints(
+    keypoints, num_ret_points: int, tolerance: float, cols: int, rows: int
+) -> np.ndarray:
+    """
+    Selects roughly num_ret_points spatially distributed OpenCV keypoints,
+    preferring the strongest ones. Returns the indices of the selected keypoints.
+    """
+    points = pack_keypoints(keypoints)
+
+    # SSC prefers the keypoints that come first, so order by response.
+    order = np.argsort(-points[:, 2], kind="stable")
+
+    return order[ssc(points[order], num_ret_points, tolerance, cols, rows)]
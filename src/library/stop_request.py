@@ -0,0 +1,77 @@
+"""
+Module for requesting the algorithm to stop without polling the keyboard on every frame.
+"""
+import os
+import signal
+import sys
+import threading
+import time
+
+
+class StopRequest:
+    """
+    Collects requests to stop from signals, stdin and a stop file.
+    """
+
+    def __init__(self, stop_file="./stop", file_check_interval=1.0):
+        self._event = threading.Event()
+        self._stop_file = stop_file
+        self._file_check_interval = file_check_interval
+        self._next_file_check = 0
+        self._installed = False
+
+    def install(self):
+        """
+        Starts listening for SIGINT, SIGTERM and "q" on stdin.
+        """
+        if self._installed:
+            return
+
+        self._installed = True
+
+        if threading.current_thread() is threading.main_thread():
+            for signal_number in (signal.SIGINT, signal.SIGTERM):
+                signal.signal(signal_number, self._handle_signal)
+
+        if sys.stdin is not None and sys.stdin.isatty():
+            threading.Thread(target=self._read_stdin, daemon=True).start()
+
+    def _handle_signal(self, signal_number, _):
+        # A second signal stops immediately.
+        if self._event.is_set():
+            signal.signal(signal_number, signal.SIG_DFL)
+            os.kill(os.getpid(), signal_number)
+
+        self._event.set()
+
+    def _read_stdin(self):
+        for line in sys.stdin:
+            if line.strip().lower() == "q":
+                self._event.set()
+                return
+
+    def request(self):
+        """
+        Requests the algorithm to stop.
+        """
+        self._event.set()
+
+    def is_requested(self) -> bool:
+        """
+        Returns true if a stop has been requested.  Does not block.
+        """
+        if self._event.is_set():
+            return True
+
+        now = time.monotonic()
+        if now >= self._next_file_check:
+            self._next_file_check = now + self._file_check_interval
+
+            if os.path.exists(self._stop_file):
+                os.remove(self._stop_file)
+                self._event.set()
+
+        return self._event.is_set()
+
+
+STOP_REQUEST = StopRequest()
@@ -0,0 +1,200 @@
+"""
+Module for storing the baboons tracked in each frame.
+"""
+import os
+import pathlib
+import tempfile
+import weakref
+from typing import Dict, List, Tuple
+
+import numpy as np
+
+from baboon_tracking.models.baboon import Baboon
+
+_RECORD = np.dtype(
+    [("x1", "<i4"), ("y1", "<i4"), ("x2", "<i4"), ("y2", "<i4"), ("identity", "<i8")]
+)
+_INDEX = np.dtype([("frame", "<i8"), ("offset", "<i8"), ("count", "<i8")])
+_NO_IDENTITY = -1
+
+
+class TrackStore:
+    """
+    Keeps the baboons of the most recent window frames in memory and appends
+    older frames to a flat binary file of fixed size records. Each spilled
+    frame also appends its offset and count to an index file next to it, and
+    both are flushed per frame, so load() can read back a store that was never
+    closed. The files are only created once the first frame is spilled.
+
+    Without a path the store spills to a temporary file in the system temporary
+    directory. It is deleted on close, when the store is garbage collected, or
+    at interpreter exit, whichever comes first.
+    """
+
+    def __init__(self, path: str = None, window: int = 2):
+        self._path = None if path is None else pathlib.Path(path)
+        self._temporary = path is None
+        self._window = window
+
+        self._recent: Dict[int, List[Baboon]] = {}
+        self._index: Dict[int, Tuple[int, int]] = {}
+        self._records = 0
+
+        self._file = None
+        self._index_file = None
+        self._map: np.memmap = None
+        self._remove: weakref.finalize = None
+
+    @property
+    def paths(self) -> Tuple[pathlib.Path, pathlib.Path]:
+        """
+        The record file and its index file, or None for a temporary store that
+        has not spilled yet.
+        """
+        if self._path is None:
+            return None, None
+
+        return self._path, _index_path(self._path)
+
+    def __contains__(self, frame_number: int) -> bool:
+        return frame_number in self._recent or frame_number in self._index
+
+    def get(self, frame_number: int) -> List[Baboon]:
+        """
+        Gets the baboons of the frame, or None if the frame was never stored.
+        """
+        if frame_number in self._recent:
+            return self._recent[frame_number]
+
+        if frame_number not in self._index:
+            return None
+
+        offset, count = self._index[frame_number]
+        if count == 0:
+            return []
+
+        # The file only grows, so a map is reused until it is too short.
+        if self._map is None or len(self._map) < offset + count:
+            self._map = np.memmap(self._path, dtype=_RECORD, mode="r")
+
+        return [_to_baboon(r) for r in self._map[offset : offset + count]]
+
+    def set(self, frame_number: int, baboons: List[Baboon]):
+        """
+        Stores the baboons of the frame, spilling the oldest frame to the file
+        once more than window frames are held.
+        """
+        self._recent[frame_number] = baboons
+
+        if len(self._recent) > self._window:
+            min_frame = min(self._recent.keys())
+            self._append(min_frame, self._recent.pop(min_frame))
+
+    def _append(self, frame_number: int, baboons: List[Baboon]):
+        if self._file is None:
+            self._open()
+
+        rectangles = np.array([b.rectangle for b in baboons], dtype=np.int32)
+        rectangles = rectangles.reshape(-1, 4)
+
+        records = np.empty(len(baboons), dtype=_RECORD)
+        for i, field in enumerate(["x1", "y1", "x2", "y2"]):
+            records[field] = rectangles[:, i]
+        records["identity"] = [
+            _NO_IDENTITY if b.identity is None else b.identity for b in baboons
+        ]
+
+        self._file.write(records.tobytes())
+        self._file.flush()
+
+        # The records are flushed first, so the index never points past them.
+        index = np.array([(frame_number, self._records, len(baboons))], dtype=_INDEX)
+        self._index_file.write(index.tobytes())
+        self._index_file.flush()
+
+        self._index[frame_number] = (self._records, len(baboons))
+        self._records += len(baboons)
+
+    def _open(self):
+        if not self._temporary:
+            self._path.parent.mkdir(parents=True, exist_ok=True)
+            self._file = open(self._path, "wb")
+            self._index_file = open(_index_path(self._path), "wb")
+            return
+
+        descriptor, path = tempfile.mkstemp(prefix="track_store_", suffix=".bin")
+        self._path = pathlib.Path(path)
+        self._file = os.fdopen(descriptor, "wb")
+        self._index_file = open(_index_path(self._path), "wb")
+
+        # Also runs at exit, so only a killed process leaves the files behind.
+        self._remove = weakref.finalize(
+            self, _remove, [self._file, self._index_file], list(self.paths)
+        )
+
+    def close(self):
+        """
+        Closes the record and index files, and deletes them for a temporary store.
+        """
+        if self._file is None:
+            return
+
+        self._map = None
+        if self._remove is not None:
+            self._remove()
+        else:
+            self._file.close()
+            self._index_file.close()
+        self._file = None
+        self._index_file = None
+
+
+def load(path: str) -> Dict[int, List[Baboon]]:
+    """
+    Reads the spilled frames of a store, whether or not it was closed.  A frame
+    whose index entry or records were cut short is left out.
+    """
+    path = pathlib.Path(path)
+
+    index = np.fromfile(str(_index_path(path)), dtype=np.uint8)
+    index = index[: len(index) // _INDEX.itemsize * _INDEX.itemsize].view(_INDEX)
+
+    records = np.fromfile(str(path), dtype=np.uint8)
+    records = records[: len(records) // _RECORD.itemsize * _RECORD.itemsize].view(
+        _RECORD
+    )
+
+    return {
+        int(frame): [_to_baboon(r) for r in records[offset : offset + count]]
+        for frame, offset, count in index
+        if offset + count <= len(records)
+    }
+
+
+def _remove(files, paths: List[pathlib.Path]):
+    for file in files:
+        file.close()
+
+    for path in paths:
+        if path.exists():
+            path.unlink()
+
+
+def _index_path(path: pathlib.Path) -> pathlib.Path:
+    return path.with_name(path.name + ".index")
+
+
+def _to_baboon(record) -> Baboon:
+    rectangle = (
+        int(record["x1"]),
+        int(record["y1"]),
+        int(record["x2"]),
+        int(record["y2"]),
+    )
+
+    identity = int(record["identity"])
+    if identity == _NO_IDENTITY:
+        return Baboon(rectangle)
+
+    # Dead reckoning always names a baboon after its identity.
+    return Baboon(rectangle, str(identity), identity)
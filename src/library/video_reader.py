@@ -0,0 +1,88 @@
+"""
+Module for decoding a video on a background thread.
+"""
+import queue
+import threading
+from typing import Callable, Tuple
+
+import cv2
+import numpy as np
+
+
+class VideoReader:
+    """
+    Decodes a video on a background thread into a bounded queue of frames.
+    The decoder blocks when depth frames are waiting to be read.  Frames are
+    decoded into the buffers get_buffer returns, which the reader never reuses itself.
+    An exception raised while decoding is raised again by the next read.
+    """
+
+    def __init__(
+        self,
+        capture: cv2.VideoCapture,
+        depth: int,
+        get_buffer: Callable[[], np.ndarray],
+    ):
+        self._capture = capture
+        self._decoded = queue.Queue(maxsize=depth)
+        self._get_buffer = get_buffer
+        self._stop = threading.Event()
+        self._thread: threading.Thread = None
+        self._error: BaseException = None
+
+    def _run(self):
+        try:
+            self._decode()
+        except BaseException as error:  # pylint: disable=broad-except
+            self._error = error
+
+    def _decode(self):
+        while not self._stop.is_set():
+            success, frame = self._capture.read(self._get_buffer())
+
+            while not self._stop.is_set():
+                try:
+                    self._decoded.put((success, frame), timeout=0.1)
+                    break
+                except queue.Full:
+                    pass
+
+            if not success:
+                return
+
+    def read(self) -> Tuple[bool, np.array]:
+        """
+        Gets the next decoded frame.
+        """
+        if self._thread is None:
+            self._thread = threading.Thread(target=self._run, daemon=True)
+            self._thread.start()
+
+        while True:
+            try:
+                return self._decoded.get(timeout=0.1)
+            except queue.Empty:
+                pass
+
+            if not self._thread.is_alive():
+                break
+
+        # The decoder may have queued its last frame just before exiting.
+        try:
+            return self._decoded.get_nowait()
+        except queue.Empty:
+            pass
+
+        if self._error is not None:
+            raise self._error
+
+        return False, None
+
+    def stop(self):
+        """
+        Stops the background decoder.
+        """
+        self._stop.set()
+
+        if self._thread is not None:
+            self._thread.join()
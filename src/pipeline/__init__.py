@@ -6,4 +6,6 @@ from .stage import Stage
 from .stage_result import StageResult
 from .serial import Serial
 from .parallel import Parallel
+from .pipelined import Pipelined
 from .config_serial import ConfigSerial
+from .graph import Graph
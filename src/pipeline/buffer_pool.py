@@ -0,0 +1,83 @@
+"""
+Recycles the arrays stages write their outputs to.
+"""
+import threading
+from typing import Dict, List, Tuple
+
+import numpy as np
+
+from pipeline import tracing
+
+
+class BufferPool:
+    """
+    Hands out arrays keyed by shape and dtype.  An array handed out while a
+    frame is processed is leased to that frame and returns to the pool when
+    the frame is released, once it has left the pipeline.  So a stage may
+    only publish a pooled array for the frame it got it for, and must not
+    keep it for later frames.  Arrays handed out outside of a frame are never
+    recycled.  The contents of an array handed out are undefined, like those
+    of np.empty.
+    """
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._free: Dict[Tuple[Tuple[int, ...], np.dtype], List[np.ndarray]] = {}
+        self._leases: Dict[int, List[np.ndarray]] = {}
+
+    def get(self, shape: Tuple[int, ...], dtype=np.uint8) -> np.ndarray:
+        """
+        Gets an array of the shape and dtype, leased to the current frame.
+        """
+        key = (tuple(shape), np.dtype(dtype))
+
+        with self._lock:
+            free = self._free.get(key)
+            buffer = free.pop() if free else None
+
+        if buffer is None:
+            buffer = np.empty(shape, dtype=dtype)
+
+        self.lease(buffer)
+
+        return buffer
+
+    def get_like(self, array: np.ndarray) -> np.ndarray:
+        """
+        Gets an array of the shape and dtype of array, leased to the current frame.
+        """
+        return self.get(array.shape, array.dtype)
+
+    def lease(self, buffer: np.ndarray):
+        """
+        Leases an array to the current frame, so that it joins the pool once
+        the frame is released.
+        """
+        frame = tracing.get_frame()
+        if frame is None:
+            return
+
+        with self._lock:
+            self._leases.setdefault(frame, []).append(buffer)
+
+    def release(self, frame: int):
+        """
+        Returns the arrays leased to the frame and every earlier frame to the
+        pool.  The pool keeps as many arrays of each shape and dtype as those
+        frames used and drops the shapes they did not use, so it does not
+        grow past what one frame needs.
+        """
+        with self._lock:
+            released: Dict[Tuple[Tuple[int, ...], np.dtype], List[np.ndarray]] = {}
+            for leased_frame in [f for f in self._leases if f <= frame]:
+                for buffer in self._leases.pop(leased_frame):
+                    key = (buffer.shape, buffer.dtype)
+                    released.setdefault(key, []).append(buffer)
+
+            if not released:
+                return
+
+            self._free = {
+                key: (self._free.get(key, []) + buffers)[: len(buffers)]
+                for key, buffers in released.items()
+            }
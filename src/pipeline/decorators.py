@@ -52,6 +52,32 @@ def stage(parameter: str, is_property=False):
     return inner_function
 
 
+def buffer_pool(parameter: str):
+    """
+    Satisfies a parameter with the buffer pool shared by the stages of the pipeline.
+    """
+
+    def inner_function(function: Callable):
+        if not hasattr(function, "buffer_pools"):
+            function.buffer_pools = []
+
+        function.buffer_pools.append(parameter)
+
+        return function
+
+    return inner_function
+
+
+def main_thread(function: Callable):
+    """
+    Executes the stage on the thread that executes the pipeline.  Used by stages that call HighGUI.
+    """
+
+    function.main_thread = True
+
+    return function
+
+
 def runtime_config(parameter: str, is_property=False):
     """
     Satisfies a parameter with the runtime configuration
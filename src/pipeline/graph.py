@@ -0,0 +1,256 @@
+"""
+Executes child stages as soon as the stages they depend on have executed.
+"""
+from concurrent.futures import FIRST_COMPLETED, Future, ThreadPoolExecutor, wait
+import os
+from typing import Callable, Dict, List, Tuple
+
+import numpy as np
+from PIL import Image, ImageDraw
+
+from pipeline import memory, tracing
+from pipeline.parent_stage import ParentStage
+from pipeline.stage import Stage
+from pipeline.stage_result import StageResult
+from pipeline.threads import needs_main_thread, prepare_worker_threads
+
+
+class Graph(ParentStage):
+    """
+    Executes child stages as soon as the stages they depend on have executed.
+    The dependencies are the stages declared using the stage and last_stage decorators.
+    Nested serial and parallel stages are flattened, so independent branches execute concurrently.
+    A short circuit skips every stage declared after the stage that returned it, like in a serial pipeline.
+    Stages that already started by then finish, but their results are dropped along with the frame.
+    """
+
+    def __init__(
+        self, name: str, runtime_config: Dict[str, any], *stage_types: List[Callable]
+    ):
+        ParentStage.__init__(self, name, runtime_config, *stage_types)
+
+        self._workers = os.cpu_count()
+        if runtime_config is not None and runtime_config.get("graph_workers"):
+            self._workers = runtime_config["graph_workers"]
+
+        self.leaves = self._get_leaves(self)
+        self._order = {leaf: i for i, leaf in enumerate(self.leaves)}
+        self.graph: Dict[Stage, List[Stage]] = {
+            leaf: [
+                l
+                for l in self.leaves
+                if l is not leaf and any(d.contains(l) for d in leaf.get_dependencies())
+            ]
+            for leaf in self.leaves
+        }
+        self._groups = self._get_groups(self)
+
+        self._executor: ThreadPoolExecutor = None
+
+    def _get_leaves(self, stage: Stage) -> List[Stage]:
+        if stage is not self and not isinstance(stage, ParentStage):
+            return [stage]
+
+        return [l for s in stage.stages for l in self._get_leaves(s)]
+
+    def _get_groups(self, stage: ParentStage) -> List[Tuple[Stage, List[Stage]]]:
+        """
+        Gets the nested parent stages along with their leaves.  Used for timing.
+        """
+
+        groups = []
+        for child in stage.stages:
+            if isinstance(child, ParentStage):
+                groups.append((child, self._get_leaves(child)))
+                groups.extend(self._get_groups(child))
+
+        return groups
+
+    def get_depths(self) -> Dict[Stage, int]:
+        """
+        Gets the length of the longest chain of dependencies leading to each leaf.
+        """
+
+        depths: Dict[Stage, int] = {}
+        for leaf in self.leaves:
+            depths[leaf] = max([depths[d] + 1 for d in self.graph[leaf]], default=0)
+
+        return depths
+
+    def _execute_stage(
+        self, stage: Stage, frame: int = None, measurement=None
+    ) -> StageResult:
+        # Pool threads work on the frame of the thread that submitted the stage,
+        # and account their memory to the stage that submitted it.
+        if frame is not None:
+            tracing.set_frame(frame)
+        memory.set_measurement(measurement)
+
+        stage.before_execute()
+        result = stage.execute()
+        stage.after_execute()
+
+        return result
+
+    def _is_ready(self, leaf: Stage, results: Dict[Stage, StageResult]) -> bool:
+        return all(d in results for d in self.graph[leaf])
+
+    def _get_cutoff(self, results: Dict[Stage, StageResult]) -> int:
+        """
+        Gets the declaration index of the first leaf that short circuited.
+        """
+
+        return min(
+            [
+                self._order[l]
+                for l, r in results.items()
+                if r is not None and not (r.continue_pipeline and r.next_stage)
+            ],
+            default=len(self.leaves),
+        )
+
+    def execute(self) -> StageResult:
+        """
+        Executes each stage once all of the stages it depends on have executed.
+        """
+
+        if self._executor is None:
+            prepare_worker_threads()
+            self._executor = ThreadPoolExecutor(
+                max_workers=self._workers, thread_name_prefix=self.name
+            )
+
+        # A result of None means the stage was skipped.
+        results: Dict[Stage, StageResult] = {}
+        in_flight: Dict[Future, Stage] = {}
+        started_groups = set()
+
+        while len(results) < len(self.leaves):
+            ready = [
+                l
+                for l in self.leaves
+                if l not in results
+                and l not in in_flight.values()
+                and self._is_ready(l, results)
+            ]
+
+            cutoff = self._get_cutoff(results)
+            for leaf in [l for l in ready if self._order[l] > cutoff]:
+                ready.remove(leaf)
+                results[leaf] = None
+
+            for group, leaves in self._groups:
+                if group not in started_groups and any(l in leaves for l in ready):
+                    started_groups.add(group)
+                    group.before_execute()
+
+            local = [l for l in ready if needs_main_thread(l)]
+
+            # Executing on the calling thread avoids a hand off when the graph is a chain.
+            if not local and not in_flight and len(ready) == 1:
+                local = ready
+
+            for leaf in [l for l in ready if l not in local]:
+                future = self._executor.submit(
+                    self._execute_stage,
+                    leaf,
+                    tracing.get_frame(),
+                    memory.get_measurement(),
+                )
+                in_flight[future] = leaf
+
+            for leaf in local:
+                if self._order[leaf] > self._get_cutoff(results):
+                    results[leaf] = None
+                else:
+                    results[leaf] = self._execute_stage(leaf)
+
+            if not local and in_flight:
+                done, _ = wait(in_flight.keys(), return_when=FIRST_COMPLETED)
+
+                for future in done:
+                    results[in_flight.pop(future)] = future.result()
+
+            for group, leaves in self._groups:
+                if group in started_groups and all(l in results for l in leaves):
+                    started_groups.remove(group)
+                    group.after_execute()
+
+        if any(r is not None and not r.continue_pipeline for r in results.values()):
+            return StageResult(False, None)
+
+        return StageResult(True, self._get_cutoff(results) == len(self.leaves))
+
+    def on_destroy(self) -> None:
+        ParentStage.on_destroy(self)
+
+        if self._executor is not None:
+            self._executor.shutdown()
+            self._executor = None
+
+    def flowchart(self):
+        """
+        Generates a chart that represents the dependencies between the stages of this pipeline.
+        """
+
+        font = self._get_font(16)
+
+        subcharts: Dict[Stage, Tuple[Image.Image, Tuple[int, int], Tuple[int, int]]] = {
+            l: l.flowchart() for l in self.leaves
+        }
+        depths = self.get_depths()
+        columns = [
+            [l for l in self.leaves if depths[l] == d]
+            for d in range(max(depths.values()) + 1)
+        ]
+
+        column_widths = [max([subcharts[l][0].size[0] for l in c]) for c in columns]
+        column_heights = [
+            sum([subcharts[l][0].size[1] for l in c]) + 20 * (len(c) - 1)
+            for c in columns
+        ]
+
+        title_height = font.getsize(self.name)[1]
+        width = sum(column_widths) + 60 * (len(columns) - 1) + 20
+        height = title_height + 30 + max(column_heights)
+
+        img = Image.new("1", (width, height))
+        draw = ImageDraw.Draw(img)
+
+        self._draw_rectangle(img, draw)
+        draw.text((10, 9), self.name, font=font)
+
+        origins: Dict[Stage, np.array] = {}
+        x_coord = 10
+        for column, column_width, column_height in zip(
+            columns, column_widths, column_heights
+        ):
+            origin = np.array(
+                [x_coord, title_height + 20 + (max(column_heights) - column_height) / 2]
+            )
+
+            for leaf in column:
+                sub, _, _ = subcharts[leaf]
+                width_pad = int((column_width - sub.size[0]) / 2)
+
+                origins[leaf] = origin + np.array([width_pad, 0])
+                img.paste(sub, self._array2tuple(origins[leaf].astype(int)))
+
+                origin = origin + np.array([0, sub.size[1] + 20])
+
+            x_coord += column_width + 60
+
+        for leaf, dependencies in self.graph.items():
+            for dependency in dependencies:
+                _, _, start = subcharts[dependency]
+                _, end, _ = subcharts[leaf]
+
+                start = self._array2tuple(np.array(start) + origins[dependency])
+                end = self._array2tuple(np.array(end) + origins[leaf])
+
+                draw.line([start, end], fill="black", width=2)
+
+        start = self._array2tuple((0, img.size[1] / 2))
+        end = self._array2tuple((img.size[0], img.size[1] / 2))
+
+        return (img, start, end)
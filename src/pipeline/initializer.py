@@ -49,6 +49,7 @@ def initializer(
             ][0]
 
             func(result, most_recent_mixin)
+            result.dependencies.append(most_recent_mixin)
 
     if hasattr(function, "runtime_configuration"):
         for parameter, is_property in function.runtime_configuration:
@@ -0,0 +1,182 @@
+"""
+Measures the memory allocated by every stage execution with tracemalloc.
+"""
+import resource
+import sys
+import threading
+import tracemalloc
+from typing import Dict, List
+import weakref
+
+import numpy as np
+
+
+class _Measurement:
+    def __init__(self, traced: int, rss: int, parent: "_Measurement"):
+        self.traced = traced
+        self.peak = traced
+        self.rss = rss
+        self.arrays = 0
+        self.parent = parent
+
+
+class MemoryProfiler:
+    """
+    Measures traced bytes, resident memory and new output arrays over stage
+    executions.  Measurements nest on each thread, so a parent stage accounts
+    for its children, including those it hands to other threads.
+    The traced memory is process wide, so stages running concurrently see each
+    other's allocations.
+    """
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._open: List[_Measurement] = []
+        # The innermost open measurement of each thread, which nests the others.
+        self._current = threading.local()
+        self._outputs: Dict[any, Dict[int, weakref.ref]] = {}
+
+        tracemalloc.start()
+
+    def _fold_peak(self):
+        # Every open measurement saw the peak since the last reset.
+        _, peak = tracemalloc.get_traced_memory()
+        for measurement in self._open:
+            measurement.peak = max(measurement.peak, peak)
+
+        tracemalloc.reset_peak()
+
+    def begin(self) -> _Measurement:
+        """
+        Starts measuring an execution.
+        """
+        with self._lock:
+            self._fold_peak()
+
+            traced, _ = tracemalloc.get_traced_memory()
+            measurement = _Measurement(traced, _get_max_rss(), self.get_current())
+            self._open.append(measurement)
+            self._current.measurement = measurement
+
+        return measurement
+
+    def end(self, measurement: _Measurement, stage):
+        """
+        Stops measuring an execution of the stage and returns the bytes allocated
+        above the traced memory at its start, the bytes it left allocated, the
+        growth of the peak resident set size and the number of arrays the stage
+        and the stages it contains output that they did not output before.
+        """
+        # Arrays are remembered by weak reference while they live, as the id of
+        # a freed array is reused.  Arrays recycled from the buffer pool are
+        # only counted the first time.
+        outputs = self._outputs.setdefault(stage, {})
+        for i in [i for i, a in outputs.items() if a() is None]:
+            del outputs[i]
+
+        arrays = {id(a): a for a in _get_output_arrays(stage) if id(a) not in outputs}
+        outputs.update({i: weakref.ref(a) for i, a in arrays.items()})
+
+        with self._lock:
+            self._fold_peak()
+            self._open.remove(measurement)
+            self._current.measurement = measurement.parent
+
+            traced, _ = tracemalloc.get_traced_memory()
+            rss = _get_max_rss()
+
+            # Only the measurements this one is nested in contain the stage.
+            parent = measurement
+            while parent is not None:
+                parent.arrays += len(arrays)
+                parent = parent.parent
+
+        return (
+            measurement.peak - measurement.traced,
+            traced - measurement.traced,
+            rss - measurement.rss,
+            measurement.arrays,
+        )
+
+    def get_current(self) -> _Measurement:
+        """
+        Gets the innermost measurement open on the calling thread.
+        """
+        return getattr(self._current, "measurement", None)
+
+    def set_current(self, measurement: _Measurement):
+        """
+        Nests the measurements the calling thread begins in the measurement.
+        """
+        self._current.measurement = measurement
+
+    def stop(self):
+        """
+        Stops tracing allocations.
+        """
+        tracemalloc.stop()
+
+
+def _get_max_rss() -> int:
+    # macOS reports the peak resident set size in bytes, Linux in kilobytes.
+    max_rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    if sys.platform == "darwin":
+        return max_rss
+
+    return max_rss * 1024
+
+
+def _get_output_arrays(stage):
+    # Arrays held by the stage's attributes, directly, in a sequence or in a
+    # model such as Frame.  Other stages are not followed.
+    values = list(vars(stage).values())
+    for value in list(values):
+        if isinstance(value, (list, tuple)):
+            values.extend(value)
+
+    for value in list(values):
+        if hasattr(value, "__dict__") and not hasattr(value, "execute"):
+            values.extend(vars(value).values())
+
+    return [v for v in values if isinstance(v, np.ndarray)]
+
+
+profiler: MemoryProfiler = None
+
+
+def get_measurement() -> _Measurement:
+    """
+    Gets the innermost measurement open on the calling thread, if profiling.
+    """
+    if profiler is None:
+        return None
+
+    return profiler.get_current()
+
+
+def set_measurement(measurement: _Measurement):
+    """
+    Nests the measurements the calling thread begins in the measurement.
+    """
+    if profiler is not None and measurement is not None:
+        profiler.set_current(measurement)
+
+
+def start_profiling():
+    """
+    Starts measuring the memory of stage executions.
+    """
+    global profiler  # pylint: disable=global-statement,invalid-name
+    profiler = MemoryProfiler()
+
+
+def stop_profiling():
+    """
+    Stops measuring the memory of stage executions.
+    """
+    global profiler  # pylint: disable=global-statement,invalid-name
+    if profiler is None:
+        return
+
+    profiler.stop()
+    profiler = None
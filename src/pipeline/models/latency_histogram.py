@@ -0,0 +1,75 @@
+"""
+Contains a histogram for recording latencies.
+"""
+from typing import List
+
+# Each power of two range is split into this many linear buckets, bounding the
+# relative error of a recorded latency to 1 / _HALF_BUCKETS (1.6%).
+_SUB_BUCKET_BITS = 7
+_SUB_BUCKETS = 1 << _SUB_BUCKET_BITS
+_HALF_BUCKETS = _SUB_BUCKETS // 2
+
+
+def _bucket_index(microseconds: int) -> int:
+    if microseconds < _SUB_BUCKETS:
+        return microseconds
+
+    shift = microseconds.bit_length() - _SUB_BUCKET_BITS
+    return (
+        _SUB_BUCKETS
+        + (shift - 1) * _HALF_BUCKETS
+        + (microseconds >> shift)
+        - _HALF_BUCKETS
+    )
+
+
+def _bucket_upper_bound(index: int) -> int:
+    if index < _SUB_BUCKETS:
+        return index
+
+    shift = (index - _SUB_BUCKETS) // _HALF_BUCKETS + 1
+    mantissa = (index - _SUB_BUCKETS) % _HALF_BUCKETS + _HALF_BUCKETS
+    return ((mantissa + 1) << shift) - 1
+
+
+class LatencyHistogram:
+    """
+    A log-linear (HDR style) histogram of latencies with microsecond resolution.
+    Recording is a bucket increment, so it can be done on every execution.
+    """
+
+    def __init__(self):
+        self._counts: List[int] = []
+        self.count = 0
+        self.total = 0.0
+        self.max = 0.0
+
+    def record(self, seconds: float):
+        """
+        Records one latency.
+        """
+        index = _bucket_index(int(seconds * 1000000))
+        if index >= len(self._counts):
+            self._counts.extend([0] * (index + 1 - len(self._counts)))
+
+        self._counts[index] += 1
+        self.count += 1
+        self.total += seconds
+        self.max = max(self.max, seconds)
+
+    def percentile(self, percent: float) -> float:
+        """
+        Gets the latency in seconds that percent of the recorded latencies don't exceed.
+        """
+        if not self.count:
+            return 0
+
+        rank = max(1, -(-self.count * percent // 100))
+        seen = 0
+        for index, count in enumerate(self._counts):
+            seen += count
+
+            if seen >= rank:
+                return min(_bucket_upper_bound(index) / 1000000, self.max)
+
+        return self.max
@@ -0,0 +1,42 @@
+"""
+Contains objects for accumulating the memory used by stage executions.
+"""
+
+
+class MemoryUsage:
+    """
+    Accumulates the memory measured over the executions of a stage.
+    """
+
+    def __init__(self):
+        self.count = 0
+        self.allocated = 0
+        self.max_allocated = 0
+        self.retained = 0
+        self.rss_growth = 0
+        self.arrays = 0
+
+    def record(self, allocated: int, retained: int, rss_growth: int, arrays: int):
+        """
+        Adds the measurement of one execution.
+        """
+        self.count += 1
+        self.allocated += allocated
+        self.max_allocated = max(self.max_allocated, allocated)
+        self.retained += retained
+        self.rss_growth += rss_growth
+        self.arrays += arrays
+
+    def __str__(self):
+        megabyte = 1024 * 1024
+
+        return (
+            "allocated {allocated} MB, max {max_allocated} MB, retained {retained} MB,"
+            " {arrays} arrays, peak RSS growth {rss_growth} MB total".format(
+                allocated=round(self.allocated / self.count / megabyte, 2),
+                max_allocated=round(self.max_allocated / megabyte, 2),
+                retained=round(self.retained / self.count / megabyte, 2),
+                arrays=round(self.arrays / self.count, 1),
+                rss_growth=round(self.rss_growth / megabyte, 2),
+            )
+        )
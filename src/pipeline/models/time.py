@@ -1,7 +1,9 @@
 """
 Contains objects for representing slices of time.
 """
-from typing import Iterable
+from typing import Dict, Iterable
+
+from pipeline.models.memory_usage import MemoryUsage
 
 
 class Time:
@@ -10,25 +12,49 @@ class Time:
     """
 
     def __init__(
-        self, name: str, execution_time: float, children: Iterable["Time"] = None
+        self,
+        name: str,
+        execution_time: float,
+        children: Iterable["Time"] = None,
+        percentiles: Dict[int, float] = None,
+        max_time: float = 0,
+        memory: MemoryUsage = None,
     ):
         self.name = name
         self.execution_time = execution_time
         self.children = children
+        self.percentiles = percentiles if percentiles is not None else {}
+        self.max_time = max_time
+        self.memory = memory
 
     def print_to_console(self, indentation=1):
         """
         Prints the current time object and its children to the console.
         """
 
-        print(
-            "{indentation}{name}: {execution_time} ms".format(
-                indentation=("  " * indentation),
-                name=self.name,
-                execution_time=round(self.execution_time * 1000, 2),
-            )
+        line = "{indentation}{name}: {execution_time} ms".format(
+            indentation=("  " * indentation),
+            name=self.name,
+            execution_time=round(self.execution_time * 1000, 2),
         )
 
+        if self.percentiles:
+            latencies = ", ".join(
+                "p{percent} {latency} ms".format(
+                    percent=percent, latency=round(latency * 1000, 2)
+                )
+                for percent, latency in self.percentiles.items()
+            )
+
+            line += " ({latencies}, max {max_time} ms)".format(
+                latencies=latencies, max_time=round(self.max_time * 1000, 2)
+            )
+
+        if self.memory is not None:
+            line += " [{memory}]".format(memory=self.memory)
+
+        print(line)
+
         if self.children:
             for child in self.children:
                 child.print_to_console(indentation + 1)
@@ -1,13 +1,17 @@
 """
 Executes child stages in parallel.
 """
+from concurrent.futures import ThreadPoolExecutor
 from typing import Callable, List, Tuple, Dict
 
 import numpy as np
 from PIL import Image, ImageDraw
 
+from pipeline import memory, tracing
 from pipeline.parent_stage import ParentStage
+from pipeline.stage import Stage
 from pipeline.stage_result import StageResult
+from pipeline.threads import needs_main_thread, prepare_worker_threads
 
 
 class Parallel(ParentStage):
@@ -20,15 +24,131 @@ class Parallel(ParentStage):
     ):
         ParentStage.__init__(self, name, runtime_config, *stage_types)
 
+        self._concurrent = runtime_config is None or runtime_config.get(
+            "parallel", True
+        )
+        self._sibling_dependencies = {
+            stage: [
+                s
+                for s in self.stages
+                if s is not stage
+                and any(s.contains(d) for d in stage.get_dependencies())
+            ]
+            for stage in self.stages
+        }
+        self._waves = self._get_waves()
+        self._executor: ThreadPoolExecutor = None
+
+    def _get_waves(self) -> List[List[Stage]]:
+        """
+        Groups the child stages so that a stage only runs after the siblings it consumes.
+        """
+
+        waves: List[List[Stage]] = []
+        wave_index: Dict[Stage, int] = {}
+
+        for stage in self.stages:
+            index = max(
+                [wave_index[s] + 1 for s in self._sibling_dependencies[stage]],
+                default=0,
+            )
+
+            if index == len(waves):
+                waves.append([])
+
+            waves[index].append(stage)
+            wave_index[stage] = index
+
+        return waves
+
+    def _execute_stage(
+        self, stage: Stage, frame: int = None, measurement=None
+    ) -> StageResult:
+        # Pool threads work on the frame of the thread that submitted the stage,
+        # and account their memory to the stage that submitted it.
+        if frame is not None:
+            tracing.set_frame(frame)
+        memory.set_measurement(measurement)
+
+        stage.before_execute()
+        result = stage.execute()
+        stage.after_execute()
+
+        return result
+
+    def _execute_concurrently(self) -> Dict[Stage, StageResult]:
+        if self._executor is None:
+            prepare_worker_threads()
+            self._executor = ThreadPoolExecutor(
+                max_workers=max(max(len(w) for w in self._waves) - 1, 1),
+                thread_name_prefix=self.name,
+            )
+
+        results: Dict[Stage, StageResult] = {}
+        for wave in self._waves:
+            # Skip the stages whose sibling dependencies were skipped or short circuited.
+            wave = [
+                s
+                for s in wave
+                if all(
+                    d in results
+                    and results[d].continue_pipeline
+                    and results[d].next_stage
+                    for d in self._sibling_dependencies[s]
+                )
+            ]
+
+            if not wave:
+                continue
+
+            # The calling thread executes the main thread stages, or the last stage instead of waiting idle.
+            local = [s for s in wave if needs_main_thread(s)] or wave[-1:]
+            futures = [
+                (
+                    s,
+                    self._executor.submit(
+                        self._execute_stage,
+                        s,
+                        tracing.get_frame(),
+                        memory.get_measurement(),
+                    ),
+                )
+                for s in wave
+                if s not in local
+            ]
+            for stage in local:
+                results[stage] = self._execute_stage(stage)
+
+            for stage, future in futures:
+                results[stage] = future.result()
+
+        return results
+
     def execute(self) -> StageResult:
         """
         Executes all stages in this pipeline in parallel.
         """
 
+        if not self._concurrent:
+            for stage in self.stages:
+                result = self._execute_stage(stage)
+
+                if result.continue_pipeline and not result.next_stage:
+                    break
+
+                if not result.continue_pipeline:
+                    return StageResult(False, None)
+
+            return StageResult(True, True)
+
+        results = self._execute_concurrently()
+
+        # Results are inspected in declaration order, which keeps the same short circuit semantics as executing serially.
         for stage in self.stages:
-            stage.before_execute()
-            result = stage.execute()
-            stage.after_execute()
+            if stage not in results:
+                break
+
+            result = results[stage]
 
             if result.continue_pipeline and not result.next_stage:
                 break
@@ -38,6 +158,13 @@ class Parallel(ParentStage):
 
         return StageResult(True, True)
 
+    def on_destroy(self) -> None:
+        ParentStage.on_destroy(self)
+
+        if self._executor is not None:
+            self._executor.shutdown()
+            self._executor = None
+
     def flowchart(self):
         """
         Generates a chart that represents this pipeline.
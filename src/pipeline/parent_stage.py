@@ -4,6 +4,7 @@ Base class for Serial and Parallel classes.  Implements common functionality bet
 import inspect
 from typing import Callable, List, Dict
 
+from pipeline.buffer_pool import BufferPool
 from pipeline.initializer import initializer
 from pipeline.models.time import Time
 
@@ -16,6 +17,7 @@ class ParentStage(Stage):
     """
 
     static_stages = []
+    buffer_pool = BufferPool()
 
     def __init__(
         self, name: str, runtime_config: Dict[str, any], *stage_types: List[Callable]
@@ -29,10 +31,12 @@ class ParentStage(Stage):
         self.stages: List[Stage] = []
         for stage_type in stage_types:
             parameters_dict = {}
+            dependencies = []
 
             if hasattr(stage_type, "last_stage"):
                 for parameter in stage_type.last_stage:
                     parameters_dict[parameter] = self.stages[-1]
+                    dependencies.append(self.stages[-1])
 
             if hasattr(stage_type, "stages"):
                 for stage, is_property in stage_type.stages:
@@ -49,6 +53,11 @@ class ParentStage(Stage):
                     ][0]
 
                     parameters_dict[stage] = most_recent_mixin
+                    dependencies.append(most_recent_mixin)
+
+            if hasattr(stage_type, "buffer_pools"):
+                for parameter in stage_type.buffer_pools:
+                    parameters_dict[parameter] = self.buffer_pool
 
             if hasattr(stage_type, "runtime_configuration"):
                 for parameter, is_property in stage_type.runtime_configuration:
@@ -62,8 +71,28 @@ class ParentStage(Stage):
                     stage_type, parameters_dict, runtime_config, self.static_stages,
                 )
             )
+            self.stages[-1].dependencies.extend(dependencies)
             self.static_stages.append(self.stages[-1])
 
+    def get_dependencies(self) -> List[Stage]:
+        """
+        Gets the stages outside of this stage whose results are consumed by this stage or its children.
+        """
+
+        dependencies = [
+            d for s in self.stages for d in s.get_dependencies() if not self.contains(d)
+        ]
+        dependencies.extend(self.dependencies)
+
+        return dependencies
+
+    def contains(self, stage: Stage) -> bool:
+        """
+        Returns true if the specified stage is this stage or one of its children.
+        """
+
+        return stage is self or any(s.contains(stage) for s in self.stages)
+
     def get_time(self) -> Time:
         """
         Calculates the average time per execution of this stage.
@@ -0,0 +1,279 @@
+"""
+Executes child stages as a pipeline, where each child stage works on a different frame.
+"""
+import queue
+import threading
+from typing import Callable, Dict, List, Tuple
+
+from pipeline import tracing
+from pipeline.parent_stage import ParentStage
+from pipeline.serial import Serial
+from pipeline.stage import Stage
+from pipeline.stage_result import StageResult
+from pipeline.threads import needs_main_thread, prepare_worker_threads
+
+# Messages carry the index of their frame under this key, next to the stage values.
+_FRAME = "frame"
+
+
+class StageSnapshot:
+    """
+    Stands in for a stage that belongs to an earlier segment of a pipeline.
+    Exposes the values that stage produced for the frame currently being processed.
+    """
+
+    def __init__(self, stage: Stage):
+        self.__dict__["_stage"] = stage
+        self.__dict__["_values"] = {}
+
+    def set_values(self, values: Dict[str, any]):
+        """
+        Sets the values produced by the stage for the current frame.
+        """
+
+        self.__dict__["_values"] = values
+
+    def __getattr__(self, name: str):
+        values = self.__dict__["_values"]
+
+        if name in values:
+            return values[name]
+
+        return getattr(self.__dict__["_stage"], name)
+
+
+class Pipelined(Serial):
+    """
+    Executes child stages as a pipeline, where each child stage works on a different frame.
+    Every child stage before the first one that needs the main thread has its own worker thread
+    and those children are joined by bounded queues.  The remaining children execute serially
+    on the calling thread, so each call to execute completes one frame.
+
+    Stages in later segments read the results of earlier segments through snapshots,
+    so the live stage objects of earlier segments may already be working on later frames.
+    Snapshots do not copy the values they hold, so a stage owns the values it publishes
+    for a frame only until it returns from execute: a stage that updates an array across
+    frames publishes a copy of it instead.  Arrays from the buffer pool are leased to
+    their frame, so they are only recycled once the frame has left the pipeline.
+    """
+
+    def __init__(
+        self, name: str, runtime_config: Dict[str, any], *stage_types: List[Callable]
+    ):
+        Serial.__init__(self, name, runtime_config, *stage_types)
+
+        depth = 2
+        if runtime_config is not None and "pipeline_depth" in runtime_config:
+            depth = runtime_config["pipeline_depth"]
+
+        # The index of the first segment executed on the calling thread.
+        self._main = next(
+            (i for i, s in enumerate(self.stages) if needs_main_thread(s)),
+            len(self.stages) - 1,
+        )
+
+        self._queues = [queue.Queue(maxsize=depth) for _ in range(self._main)]
+        self._snapshots = [
+            self._install_snapshots(i) for i, _ in enumerate(self.stages)
+        ]
+        self._published = [
+            [
+                s
+                for snapshots in self._snapshots[i + 1 :]
+                for s in snapshots
+                if stage.contains(s)
+            ]
+            for i, stage in enumerate(self.stages[: self._main])
+        ]
+
+        self._stop = threading.Event()
+        self._workers: List[threading.Thread] = []
+
+    def _get_descendants(self, stage: Stage) -> List[Stage]:
+        if not isinstance(stage, ParentStage):
+            return [stage]
+
+        descendants = [stage]
+        for child in stage.stages:
+            descendants.extend(self._get_descendants(child))
+
+        return descendants
+
+    def _install_snapshots(self, index: int) -> Dict[Stage, StageSnapshot]:
+        """
+        Replaces the references to the worker segments before the specified segment with snapshots.
+        """
+
+        snapshots: Dict[Stage, StageSnapshot] = {}
+        earlier_stages = self.stages[: min(index, self._main)]
+
+        for stage in self._get_descendants(self.stages[index]):
+            for attribute, value in list(vars(stage).items()):
+                if not isinstance(value, Stage) or not any(
+                    s.contains(value) for s in earlier_stages
+                ):
+                    continue
+
+                if value not in snapshots:
+                    snapshots[value] = StageSnapshot(value)
+
+                setattr(stage, attribute, snapshots[value])
+
+        return snapshots
+
+    def _publish(self, index: int, message: Dict[Stage, Dict[str, any]]):
+        for stage in self._published[index]:
+            message[stage] = {
+                k: v
+                for k, v in vars(stage).items()
+                if not k.startswith("_") and k != "dependencies"
+            }
+
+    def _restore(self, index: int, message: Dict[Stage, Dict[str, any]]):
+        for stage, snapshot in self._snapshots[index].items():
+            snapshot.set_values(message[stage])
+
+    def _put(self, index: int, item: Tuple[str, any]):
+        while not self._stop.is_set():
+            try:
+                self._queues[index].put(item, timeout=0.1)
+                return
+            except queue.Full:
+                pass
+
+    def _get(self, index: int) -> Tuple[str, any]:
+        while not self._stop.is_set():
+            try:
+                return self._queues[index].get(timeout=0.1)
+            except queue.Empty:
+                pass
+
+        return ("end", None)
+
+    def _execute_segment(
+        self, index: int, message: Dict[Stage, Dict[str, any]]
+    ) -> StageResult:
+        self._restore(index, message)
+        tracing.set_frame(message[_FRAME])
+
+        stage = self.stages[index]
+        stage.before_execute()
+        result = stage.execute()
+        stage.after_execute()
+
+        return result
+
+    def _run_worker(self, index: int):
+        frame = 0
+
+        try:
+            while not self._stop.is_set():
+                if index == 0:
+                    kind, message = ("frame", {_FRAME: frame})
+                    frame += 1
+                else:
+                    kind, message = self._get(index - 1)
+
+                if kind != "frame":
+                    self._put(index, (kind, message))
+                    return
+
+                result = self._execute_segment(index, message)
+
+                if not result.continue_pipeline:
+                    self._put(index, ("end", None))
+                    return
+
+                # The frame does not continue to the next stage.
+                if not result.next_stage:
+                    continue
+
+                self._publish(index, message)
+                self._put(index, ("frame", message))
+        except Exception as error:  # pylint: disable=broad-except
+            self._put(index, ("error", error))
+
+    def _start_workers(self):
+        prepare_worker_threads()
+
+        self._workers = [
+            threading.Thread(
+                target=self._run_worker,
+                args=(i,),
+                name="{name}.{stage}".format(name=self.name, stage=type(s).__name__),
+                daemon=True,
+            )
+            for i, s in enumerate(self.stages[: self._main])
+        ]
+
+        for worker in self._workers:
+            worker.start()
+
+    def _drain_queues(self):
+        for frames in self._queues:
+            while True:
+                try:
+                    frames.get_nowait()
+                except queue.Empty:
+                    break
+
+    def _shutdown(self):
+        """
+        Stops the workers and drops the frames still in the pipeline.
+        """
+
+        self._stop.set()
+
+        # Draining first frees a worker blocked on a full queue sooner,
+        # draining again drops what was put before the worker saw the request.
+        self._drain_queues()
+        for worker in self._workers:
+            worker.join()
+        self._drain_queues()
+
+    def _execute_main(self) -> StageResult:
+        kind, message = self._get(self._main - 1)
+
+        if kind == "error":
+            raise message
+
+        if kind == "end":
+            return StageResult(False, None)
+
+        for index in range(self._main, len(self.stages)):
+            result = self._execute_segment(index, message)
+
+            if not result.continue_pipeline:
+                return StageResult(False, None)
+
+            if not result.next_stage:
+                return StageResult(True, False)
+
+        return StageResult(True, True)
+
+    def execute(self) -> StageResult:
+        """
+        Waits for the next frame to leave the pipeline.
+        """
+
+        if self._main == 0:
+            return Serial.execute(self)
+
+        if not self._workers:
+            self._start_workers()
+
+        try:
+            result = self._execute_main()
+        except BaseException:
+            self._shutdown()
+            raise
+
+        if not result.continue_pipeline:
+            self._shutdown()
+
+        return result
+
+    def on_destroy(self) -> None:
+        self._shutdown()
+
+        Serial.on_destroy(self)
@@ -2,7 +2,7 @@
 Provides a super class for stages of a pipeline.
 """
 from abc import ABC, abstractmethod
-from typing import Tuple
+from typing import List, Tuple
 import os
 import pathlib
 import time
@@ -12,6 +12,9 @@ import zipfile
 import numpy as np
 from PIL import Image, ImageDraw, ImageFont
 
+from pipeline import memory, tracing
+from pipeline.models.latency_histogram import LatencyHistogram
+from pipeline.models.memory_usage import MemoryUsage
 from pipeline.models.time import Time
 from pipeline.stage_result import StageResult
 
@@ -23,8 +26,11 @@ class Stage(ABC):
 
     def __init__(self):
         self._start = 0
-        self._time = 0
-        self._executions = 0
+        self._latencies = LatencyHistogram()
+        self._measurement = None
+        self._memory_usage = MemoryUsage()
+
+        self.dependencies: List["Stage"] = []
 
     def _array2tuple(self, array: np.array) -> Tuple[int, int]:
         return (array[0], array[1])
@@ -62,15 +68,25 @@ class Stage(ABC):
         Executed after the execute method.
         """
 
-        self._time += time.perf_counter() - self._start
+        end = time.perf_counter()
+        self._latencies.record(end - self._start)
+
+        if tracing.tracer is not None:
+            tracing.tracer.add_span(type(self).__name__, self._start, end)
+
+        if self._measurement is not None:
+            self._memory_usage.record(*memory.profiler.end(self._measurement, self))
+            self._measurement = None
 
     def before_execute(self):
         """
         Executed before the execute method.
         """
 
+        if memory.profiler is not None:
+            self._measurement = memory.profiler.begin()
+
         self._start = time.perf_counter()
-        self._executions += 1
 
     @abstractmethod
     def execute(self) -> StageResult:
@@ -88,12 +104,37 @@ class Stage(ABC):
         Called when the application is closed, just before the pipeline is destroyed.
         """
 
+    def get_dependencies(self) -> List["Stage"]:
+        """
+        Gets the stages whose results are consumed by this stage.
+        """
+
+        return self.dependencies
+
+    def contains(self, stage: "Stage") -> bool:
+        """
+        Returns true if the specified stage is this stage or one of its children.
+        """
+
+        return stage is self
+
     def get_time(self) -> Time:
         """
-        Calculates the average time per execution of this stage.
+        Calculates the average time and the latency percentiles per execution of this stage,
+        along with its memory usage if it was measured.
         """
 
-        return Time(type(self).__name__, self._time / self._executions)
+        latencies = self._latencies
+        if not latencies.count:
+            return Time(type(self).__name__, 0)
+
+        return Time(
+            type(self).__name__,
+            latencies.total / latencies.count,
+            percentiles={p: latencies.percentile(p) for p in (50, 90, 99)},
+            max_time=latencies.max,
+            memory=self._memory_usage if self._memory_usage.count else None,
+        )
 
     def flowchart(self):
         """
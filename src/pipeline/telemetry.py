@@ -0,0 +1,135 @@
+"""
+Collects named per-frame counters published by stages and writes them as JSON lines.
+"""
+import json
+import threading
+from typing import Dict
+
+from pipeline import tracing
+
+
+class Telemetry:
+    """
+    Collects the counters of each frame, keyed by the frame index tracing keeps per thread.
+    Stages on any thread may publish while the tracker flushes, so the frames are
+    guarded by a lock.  A frame gets one line, so counters published for a frame
+    that was already written are dropped and counted in late_counters.  Counters
+    published outside of any frame are written as one line with a null frame on close.
+    """
+
+    def __init__(self, path: str):
+        self._lock = threading.Lock()
+        self._file = open(path, "w")
+        self._frames: Dict[int, Dict[str, any]] = {}
+        self._run: Dict[str, any] = {}
+        # Frames up to and including this one were written.
+        self._flushed = -1
+        self.late_counters = 0
+
+    def _get_counters(self) -> Dict[str, any]:
+        frame = tracing.get_frame()
+        if frame is None:
+            return self._run
+
+        if frame <= self._flushed:
+            self.late_counters += 1
+            return None
+
+        return self._frames.setdefault(frame, {})
+
+    def count(self, name: str, value=1):
+        """
+        Adds value to the counter of the current frame.
+        """
+        with self._lock:
+            counters = self._get_counters()
+            if counters is not None:
+                counters[name] = counters.get(name, 0) + value
+
+    def record(self, name: str, value):
+        """
+        Records a value for the current frame.  Values recorded more than once are listed.
+        """
+        with self._lock:
+            counters = self._get_counters()
+
+            if counters is None:
+                return
+            if name not in counters:
+                counters[name] = value
+            elif isinstance(counters[name], list):
+                counters[name].append(value)
+            else:
+                counters[name] = [counters[name], value]
+
+    def flush(self, frame: int = None):
+        """
+        Writes one line for every frame up to and including frame, or for every frame if frame is None.
+        """
+        with self._lock:
+            for frame_index in sorted(self._frames):
+                if frame is not None and frame_index > frame:
+                    break
+
+                self._write(frame_index, self._frames.pop(frame_index))
+
+                self._flushed = max(self._flushed, frame_index)
+
+            if frame is not None:
+                self._flushed = max(self._flushed, frame)
+
+    def _write(self, frame: int, counters: Dict[str, any]):
+        self._file.write(
+            json.dumps({"frame": frame, **counters}, separators=(",", ":")) + "\n"
+        )
+
+    def close(self):
+        """
+        Writes the remaining frames and the counters published outside of any frame,
+        then closes the file.
+        """
+        self.flush()
+
+        with self._lock:
+            if self._run:
+                self._write(None, self._run)
+                self._run = {}
+
+        self._file.close()
+
+
+recorder: Telemetry = None
+
+
+def start_telemetry(path: str):
+    """
+    Starts writing the counters of every frame to the JSON lines file at path.
+    """
+    global recorder  # pylint: disable=global-statement,invalid-name
+    recorder = Telemetry(path)
+
+
+def stop_telemetry():
+    """
+    Writes the remaining frames and stops collecting counters.
+    """
+    global recorder  # pylint: disable=global-statement,invalid-name
+    if recorder is not None:
+        recorder.close()
+        recorder = None
+
+
+def count(name: str, value=1):
+    """
+    Adds value to the counter of the current frame, if telemetry is on.
+    """
+    if recorder is not None:
+        recorder.count(name, value)
+
+
+def record(name: str, value):
+    """
+    Records a value for the current frame, if telemetry is on.
+    """
+    if recorder is not None:
+        recorder.record(name, value)
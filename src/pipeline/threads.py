@@ -0,0 +1,30 @@
+"""
+Helpers for the parent stages that execute their children on other threads.
+"""
+import numba
+
+from pipeline.parent_stage import ParentStage
+from pipeline.stage import Stage
+
+
+def prepare_worker_threads():
+    """
+    Launches the numba threading layer from the calling thread.  The process
+    never exits if the TBB layer is first launched from a worker thread, so
+    this is called before starting any.
+    """
+
+    numba.get_num_threads()
+
+
+def needs_main_thread(stage: Stage) -> bool:
+    """
+    Returns true if the stage or one of its children was declared with the main_thread decorator.
+    """
+
+    if getattr(stage, "main_thread", False):
+        return True
+
+    return isinstance(stage, ParentStage) and any(
+        needs_main_thread(s) for s in stage.stages
+    )
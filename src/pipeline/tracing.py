@@ -0,0 +1,99 @@
+"""
+Records every stage execution as a Chrome trace event, viewable in chrome://tracing or Perfetto.
+"""
+import json
+import os
+import threading
+import time
+from typing import Dict, List
+
+_local = threading.local()
+
+
+class Tracer:
+    """
+    Collects complete ("X") trace events.  Spans on the same thread nest by their times.
+    """
+
+    def __init__(self, path: str):
+        self._path = path
+        self._origin = time.perf_counter()
+        self._events: List[Dict[str, any]] = []
+        self._thread_names: Dict[int, str] = {}
+
+    def add_span(self, name: str, start: float, end: float):
+        """
+        Records a span between two time.perf_counter() values on the current thread.
+        """
+        thread = threading.current_thread()
+        if thread.ident not in self._thread_names:
+            self._thread_names[thread.ident] = thread.name
+
+        self._events.append(
+            {
+                "name": name,
+                "cat": "stage",
+                "ph": "X",
+                "ts": (start - self._origin) * 1000000,
+                "dur": (end - start) * 1000000,
+                "pid": os.getpid(),
+                "tid": thread.ident,
+                "args": {"frame": get_frame()},
+            }
+        )
+
+    def write(self):
+        """
+        Writes the trace event file.
+        """
+        thread_names = [
+            {
+                "name": "thread_name",
+                "ph": "M",
+                "pid": os.getpid(),
+                "tid": tid,
+                "args": {"name": name},
+            }
+            for tid, name in self._thread_names.items()
+        ]
+
+        with open(self._path, "w") as trace_file:
+            json.dump(
+                {"traceEvents": thread_names + self._events, "displayTimeUnit": "ms"},
+                trace_file,
+            )
+
+
+tracer: Tracer = None
+
+
+def start_tracing(path: str):
+    """
+    Starts recording stage executions to the trace event file at path.
+    """
+    global tracer  # pylint: disable=global-statement,invalid-name
+    tracer = Tracer(path)
+
+
+def stop_tracing():
+    """
+    Writes the trace event file and stops recording.
+    """
+    global tracer  # pylint: disable=global-statement,invalid-name
+    if tracer is not None:
+        tracer.write()
+        tracer = None
+
+
+def get_frame() -> int:
+    """
+    Gets the index of the frame the current thread is working on.
+    """
+    return getattr(_local, "frame", None)
+
+
+def set_frame(frame: int):
+    """
+    Sets the index of the frame the current thread is working on.
+    """
+    _local.frame = frame
@@ -90,7 +90,7 @@ def main():
             )
 
             # Press Q on keyboard to  exit
-            if cv2.waitKey(25) & 0xFF == ord("q"):
+            if cv2.waitKey(1) & 0xFF == ord("q"):
                 break
 
         # Break the loop
@@ -0,0 +1,36 @@
+import unittest
+from types import SimpleNamespace
+
+import numpy as np
+
+from baboon_tracking.models.frame import Frame
+from baboon_tracking.stages.motion_detector.apply_masks import ApplyMasks
+from pipeline.buffer_pool import BufferPool
+
+
+class TestApplyMasks(unittest.TestCase):
+    def test_masks_without_touching_the_input(self):
+        random = np.random.RandomState(0)
+        foreground = (random.randint(0, 2, (48, 64)) * 255).astype(np.uint8)
+        shifted_mask = np.zeros((48, 64), np.uint8)
+        shifted_mask[8:40, 8:56] = 255
+        unmasked = foreground.copy()
+
+        stage = ApplyMasks(
+            SimpleNamespace(moving_foreground=Frame(foreground, 1)),
+            SimpleNamespace(shifted_mask=shifted_mask),
+            SimpleNamespace(frame=Frame(foreground, 1)),
+            BufferPool(),
+        )
+        stage.execute()
+        moving_foreground = stage.moving_foreground.get_frame()
+
+        self.assertTrue(np.array_equal(foreground, unmasked))
+        self.assertFalse(np.shares_memory(moving_foreground, foreground))
+        self.assertTrue(
+            np.array_equal(moving_foreground, np.where(shifted_mask, foreground, 0))
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,90 @@
+import unittest
+
+import numpy as np
+
+from pipeline import tracing
+from pipeline.buffer_pool import BufferPool
+
+
+class TestBufferPool(unittest.TestCase):
+    def setUp(self):
+        self.pool = BufferPool()
+
+    def tearDown(self):
+        tracing.set_frame(None)
+
+    def _get(self, frame: int, count: int, shape=(4, 4), dtype=np.uint8):
+        tracing.set_frame(frame)
+        return [self.pool.get(shape, dtype) for _ in range(count)]
+
+    def test_reuses_arrays_of_released_frames(self):
+        first = self._get(0, 1)[0]
+        self.pool.release(0)
+        second = self._get(1, 1)[0]
+
+        self.assertIs(second, first)
+
+    def test_keeps_arrays_of_frames_in_flight(self):
+        first = self._get(0, 1)[0]
+        second = self._get(1, 1)[0]
+        self.pool.release(1)
+        third, fourth, fifth = self._get(2, 3)
+
+        self.assertIsNot(second, first)
+        self.assertEqual({id(third), id(fourth)}, {id(first), id(second)})
+        self.assertNotIn(id(fifth), {id(first), id(second)})
+
+    def test_release_covers_earlier_frames(self):
+        first = self._get(0, 1)[0]
+        second = self._get(1, 1)[0]
+        third = self._get(2, 1)[0]
+        self.pool.release(1)
+        reused = self._get(3, 3)
+
+        self.assertEqual({id(a) for a in reused[:2]}, {id(first), id(second)})
+        self.assertIsNot(reused[2], third)
+
+    def test_keeps_what_one_frame_needs(self):
+        leased = self._get(0, 3)
+        self.pool.release(0)
+        reused = self._get(1, 2)
+        self.pool.release(1)
+        recycled = self._get(2, 3)
+
+        self.assertEqual({id(a) for a in reused} - {id(a) for a in leased}, set())
+        self.assertEqual(len({id(a) for a in recycled} & {id(a) for a in leased}), 2)
+
+    def test_drops_shapes_released_frames_did_not_use(self):
+        first = self._get(0, 1)[0]
+        self.pool.release(0)
+        self._get(1, 1, shape=(8, 8))
+        self.pool.release(1)
+
+        self.assertIsNot(self._get(2, 1)[0], first)
+
+    def test_keys_by_shape_and_dtype(self):
+        first = self._get(0, 1)[0]
+        self.pool.release(0)
+
+        self.assertIsNot(self._get(1, 1, shape=(4, 5))[0], first)
+        self.assertIsNot(self._get(1, 1, dtype=np.float32)[0], first)
+        self.assertIs(self._get(1, 1)[0], first)
+
+    def test_does_not_recycle_arrays_outside_of_frames(self):
+        tracing.set_frame(None)
+        first = self.pool.get((4, 4))
+        self.pool.release(0)
+
+        self.assertIsNot(self._get(0, 1)[0], first)
+
+    def test_recycles_leased_arrays(self):
+        tracing.set_frame(0)
+        decoded = np.empty((4, 4), np.uint8)
+        self.pool.lease(decoded)
+        self.pool.release(0)
+
+        self.assertIs(self._get(1, 1)[0], decoded)
+
+
+if __name__ == "__main__":
+    unittest.main()
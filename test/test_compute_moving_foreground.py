@@ -0,0 +1,89 @@
+import unittest
+from types import SimpleNamespace
+
+import numpy as np
+
+from baboon_tracking.models.frame import Frame
+from baboon_tracking.stages.motion_detector.compute_moving_foreground import (
+    ComputeMovingForeground,
+)
+from pipeline.buffer_pool import BufferPool
+
+HISTORY_FRAMES = 9
+
+
+def classify(weights, foreground, dissimilarity):
+    stage = ComputeMovingForeground(
+        SimpleNamespace(history_of_dissimilarity=dissimilarity),
+        SimpleNamespace(foreground=foreground),
+        SimpleNamespace(weights=weights),
+        SimpleNamespace(frame=Frame(foreground, 1)),
+        HISTORY_FRAMES,
+        BufferPool(),
+    )
+    stage.execute()
+
+    return stage, stage.moving_foreground.get_frame()
+
+
+class TestComputeMovingForeground(unittest.TestCase):
+    def test_table_matches_the_classifier(self):
+        random = np.random.RandomState(0)
+        weights = random.randint(0, HISTORY_FRAMES, (120, 160)).astype(np.uint8)
+        foreground = random.randint(0, 256, (120, 160)).astype(np.uint8)
+        dissimilarity = random.randint(0, 256, (120, 160)).astype(np.uint8)
+
+        stage, moving_foreground = classify(weights, foreground, dissimilarity)
+
+        self.assertEqual(moving_foreground.dtype, np.uint8)
+        self.assertTrue(
+            np.array_equal(
+                moving_foreground,
+                stage._get_moving_foreground(weights, foreground, dissimilarity),
+            )
+        )
+
+    def test_table_covers_every_combination(self):
+        weights, foreground, dissimilarity = np.indices(
+            (HISTORY_FRAMES, 256, 256), dtype=np.uint8
+        )
+        shape = (HISTORY_FRAMES * 256, 256)
+
+        stage, moving_foreground = classify(
+            weights.reshape(shape),
+            foreground.reshape(shape),
+            dissimilarity.reshape(shape),
+        )
+
+        self.assertEqual(stage._decision_table.shape, (HISTORY_FRAMES, 256, 256))
+        self.assertTrue(
+            np.array_equal(
+                moving_foreground,
+                stage._get_moving_foreground(
+                    weights, foreground, dissimilarity
+                ).reshape(shape),
+            )
+        )
+
+    def test_still_background_is_not_moving(self):
+        # A pixel common to every history frame is background whatever it looks like.
+        weights = np.full((4, 4), HISTORY_FRAMES - 1, np.uint8)
+        foreground = np.full((4, 4), 255, np.uint8)
+        dissimilarity = np.zeros((4, 4), np.uint8)
+
+        _, moving_foreground = classify(weights, foreground, dissimilarity)
+
+        self.assertFalse(np.any(moving_foreground))
+
+    def test_medium_commonality_with_strong_foreground_is_moving(self):
+        weights = np.full((4, 4), HISTORY_FRAMES // 2, np.uint8)
+        foreground = np.full((4, 4), 255, np.uint8)
+        dissimilarity = np.zeros((4, 4), np.uint8)
+
+        _, moving_foreground = classify(weights, foreground, dissimilarity)
+
+        self.assertTrue(np.all(moving_foreground == 255))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,112 @@
+import unittest
+from types import SimpleNamespace
+
+import cv2
+import numpy as np
+
+from baboon_tracking.models.frame import Frame
+from baboon_tracking.stages.motion_detector.transformed_frames.compute_shifted_masks import (
+    ComputeShiftedMasks,
+    _warp_valid,
+)
+from pipeline.buffer_pool import BufferPool
+
+WIDTH, HEIGHT = 160, 120
+
+
+def compute_shifted_mask(transformation_matrices):
+    stage = ComputeShiftedMasks(
+        SimpleNamespace(transformation_matrices=transformation_matrices),
+        SimpleNamespace(processed_frame=Frame(np.zeros((HEIGHT, WIDTH), np.uint8), 1)),
+        BufferPool(),
+    )
+    stage.execute()
+
+    return stage.shifted_mask
+
+
+def warp_shifted_mask(transformation_matrices):
+    mask = np.full((HEIGHT, WIDTH), 255, dtype=np.uint8)
+    for M in transformation_matrices:
+        mask &= cv2.warpPerspective(
+            np.full((HEIGHT, WIDTH), 255, dtype=np.uint8),
+            M,
+            (WIDTH, HEIGHT),
+            flags=cv2.INTER_NEAREST,
+        )
+
+    return mask
+
+
+class TestComputeShiftedMasks(unittest.TestCase):
+    def test_identity_keeps_the_frame(self):
+        mask = compute_shifted_mask([np.eye(3)])
+
+        self.assertTrue(np.all(mask == 255))
+
+    def test_intersects_the_warped_frames(self):
+        random = np.random.RandomState(0)
+        transformation_matrices = [np.eye(3)]
+        for _ in range(8):
+            M = np.eye(3)
+            M[:2, :2] += random.uniform(-0.02, 0.02, (2, 2))
+            M[:2, 2] = random.uniform(-10, 10, 2)
+            M[2, :2] = random.uniform(-1e-4, 1e-4, 2)
+            transformation_matrices.append(M)
+
+        mask = compute_shifted_mask(transformation_matrices)
+        expected = warp_shifted_mask(transformation_matrices)
+
+        self.assertTrue(np.all((mask == 0) | (mask == 255)))
+        # Only pixels on the border of the region may be rounded differently.
+        self.assertLess(np.count_nonzero(mask != expected), WIDTH + HEIGHT)
+        self.assertGreater(np.count_nonzero(mask), WIDTH * HEIGHT // 2)
+
+    def test_matches_the_warping_fallback(self):
+        random = np.random.RandomState(1)
+        square = np.ones((3, 3), dtype=np.uint8)
+        for _ in range(20):
+            angle = random.uniform(-0.1, 0.1)
+            M = np.array(
+                [
+                    [np.cos(angle), -np.sin(angle), random.uniform(-20, 20)],
+                    [np.sin(angle), np.cos(angle), random.uniform(-20, 20)],
+                    [*random.uniform(-5e-4, 5e-4, 2), 1],
+                ]
+            )
+
+            mask = compute_shifted_mask([np.eye(3), M])
+            warped = np.full((HEIGHT, WIDTH), 255, dtype=np.uint8)
+            _warp_valid(warped, [M])
+
+            # Rasterizing and warping may only round the pixels next to the
+            # region's border differently.
+            border = cv2.dilate(warped, square) & ~cv2.erode(warped, square)
+            differ = mask != warped
+            self.assertFalse(np.any(differ & (border == 0)))
+            self.assertLess(np.count_nonzero(differ), WIDTH + HEIGHT)
+            self.assertGreater(np.count_nonzero(mask), WIDTH * HEIGHT // 2)
+
+    def test_degenerate_homography_falls_back_to_warping(self):
+        # w = 1 - x / 100 crosses zero inside the frame.
+        degenerate = np.array([[1, 0, 0], [0, 1, 0], [-0.01, 0, 1]])
+        transformation_matrices = [np.eye(3), degenerate]
+
+        mask = compute_shifted_mask(transformation_matrices)
+
+        self.assertTrue(np.any(mask))
+        self.assertTrue(
+            np.array_equal(mask, warp_shifted_mask(transformation_matrices))
+        )
+
+    def test_disjoint_frames_leave_nothing(self):
+        shifted = np.eye(3)
+        shifted[0, 2] = WIDTH
+
+        mask = compute_shifted_mask([np.eye(3), shifted])
+
+        self.assertFalse(np.any(mask))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,109 @@
+import unittest
+from types import SimpleNamespace
+from unittest import mock
+
+import cv2
+import numpy as np
+
+from baboon_tracking.models.frame import Frame
+from baboon_tracking.stages.motion_detector import detect_blobs as detect_blobs_module
+from baboon_tracking.stages.motion_detector.detect_blobs import (
+    DetectBlobs,
+    _connected_components,
+)
+
+
+def create_detect_blobs(mask, min_size=5, rconfig=None):
+    detect = DetectBlobs(
+        min_size,
+        SimpleNamespace(moving_foreground=Frame(mask, 1)),
+        {"display": False} if rconfig is None else rconfig,
+    )
+    detect.show_result_set_runtime_config({"display": False})
+
+    return detect
+
+
+def detect_blobs(mask, min_size=5):
+    detect = create_detect_blobs(mask, min_size)
+    detect.execute()
+
+    return sorted(b.rectangle for b in detect.baboons)
+
+
+class TestDetectBlobs(unittest.TestCase):
+    def test_boxes_blobs(self):
+        mask = np.zeros((60, 80), np.uint8)
+        mask[10:20, 5:15] = 255
+        mask[30:35, 40:60] = 255
+
+        self.assertListEqual(detect_blobs(mask), [(5, 10, 15, 20), (40, 30, 60, 35)])
+
+    def test_drops_small_boxes(self):
+        mask = np.zeros((60, 80), np.uint8)
+        mask[10:20, 5:15] = 255
+        mask[40:42, 40:42] = 255
+
+        self.assertListEqual(detect_blobs(mask, 5), [(5, 10, 15, 20)])
+        self.assertEqual(len(detect_blobs(mask, 1)), 2)
+
+    def test_boxes_only_the_outside_of_holes(self):
+        mask = np.zeros((60, 80), np.uint8)
+        mask[10:40, 10:40] = 255
+        mask[20:30, 20:30] = 0
+
+        self.assertListEqual(detect_blobs(mask), [(10, 10, 40, 40)])
+
+    def test_packs_boxes_areas_and_centroids(self):
+        mask = np.zeros((60, 80), np.uint8)
+        mask[10:20, 5:15] = 255
+        mask[40:42, 40:42] = 255
+
+        detect = create_detect_blobs(mask)
+        detect.execute()
+
+        self.assertListEqual(detect.blobs.tolist(), [[5, 10, 15, 20, 100, 9.5, 14.5]])
+
+    def test_labels_tiles_like_the_whole_frame(self):
+        random = np.random.RandomState(0)
+        for density in (0.001, 0.01, 0.3):
+            mask = np.where(random.random_sample((90, 120)) < density, 255, 0)
+            mask = cv2.dilate(mask.astype(np.uint8), np.ones((3, 3), np.uint8))
+
+            stats, centroids = _connected_components(mask)
+            _, _, expected_stats, expected_centroids = cv2.connectedComponentsWithStats(
+                mask, connectivity=8
+            )
+
+            self.assertListEqual(
+                sorted(zip(stats.tolist(), centroids.tolist())),
+                sorted(
+                    zip(expected_stats[1:].tolist(), expected_centroids[1:].tolist())
+                ),
+            )
+
+    def test_labels_an_empty_mask(self):
+        stats, centroids = _connected_components(np.zeros((8, 8), np.uint8))
+
+        self.assertEqual(stats.shape, (0, 5))
+        self.assertEqual(centroids.shape, (0, 2))
+
+    def test_draws_only_for_a_display(self):
+        mask = np.zeros((8, 8), np.uint8)
+        for rconfig, display, draws in (
+            ({"display": False}, True, False),
+            ({}, True, False),
+            ({"display": True}, False, False),
+            ({"display": True}, True, True),
+        ):
+            with mock.patch.object(
+                detect_blobs_module, "has_display", return_value=display
+            ):
+                detect = create_detect_blobs(mask, rconfig=rconfig)
+            detect.execute()
+
+            self.assertEqual(detect.blob_image is not None, draws)
+
+
+if __name__ == "__main__":
+    unittest.main()
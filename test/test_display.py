@@ -0,0 +1,23 @@
+import unittest
+from unittest import mock
+
+from library.display import has_display
+
+
+class TestDisplay(unittest.TestCase):
+    def test_only_linux_needs_display_variable(self):
+        with mock.patch.dict("os.environ", {}, clear=True):
+            with mock.patch("sys.platform", "linux"):
+                self.assertFalse(has_display())
+
+            for platform in ("win32", "darwin"):
+                with mock.patch("sys.platform", platform):
+                    self.assertTrue(has_display())
+
+        with mock.patch.dict("os.environ", {"DISPLAY": ":0"}):
+            with mock.patch("sys.platform", "linux"):
+                self.assertTrue(has_display())
+
+
+if __name__ == "__main__":
+    unittest.main()
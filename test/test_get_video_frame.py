@@ -0,0 +1,93 @@
+import os
+import tempfile
+import unittest
+
+import cv2
+import numpy as np
+
+from baboon_tracking.stages.get_video_frame import GetVideoFrame
+from pipeline import tracing
+from pipeline.buffer_pool import BufferPool
+
+FRAMES = 6
+
+
+class TestGetVideoFrame(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.directory = tempfile.TemporaryDirectory()
+        cls.path = os.path.join(cls.directory.name, "input.avi")
+
+        writer = cv2.VideoWriter(
+            cls.path, cv2.VideoWriter_fourcc(*"MJPG"), 10, (32, 24)
+        )
+        for i in range(FRAMES):
+            writer.write(np.full((24, 32, 3), i * 40, np.uint8))
+        writer.release()
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.directory.cleanup()
+
+    def tearDown(self):
+        tracing.set_frame(None)
+
+    def _read_all(self, read_ahead: int, release: bool):
+        pool = BufferPool()
+        stage = GetVideoFrame(self.path, {"read_ahead": read_ahead}, pool)
+
+        frames = []
+        copies = []
+        step = 0
+        while True:
+            tracing.set_frame(step)
+            if not stage.execute().continue_pipeline:
+                break
+
+            frames.append(stage.frame.get_frame())
+            copies.append(frames[-1].copy())
+            if release:
+                pool.release(step)
+            step += 1
+
+        stage.on_destroy()
+
+        return frames, copies
+
+    def test_read_ahead_matches_synchronous_decoding(self):
+        _, synchronous = self._read_all(0, True)
+        _, read_ahead = self._read_all(2, True)
+
+        self.assertEqual(len(synchronous), FRAMES)
+        for expected, actual in zip(synchronous, read_ahead):
+            np.testing.assert_array_equal(actual, expected)
+
+    def test_keeps_frames_until_released(self):
+        for read_ahead in (0, 2):
+            frames, _ = self._read_all(read_ahead, False)
+
+            self.assertEqual(len({id(f) for f in frames}), FRAMES)
+            self.assertEqual([int(f.mean() // 40) for f in frames], list(range(FRAMES)))
+
+    def test_reuses_released_frames(self):
+        frames, copies = self._read_all(0, True)
+
+        self.assertLess(len({id(f) for f in frames}), FRAMES)
+        self.assertEqual([int(f.mean() // 40) for f in copies], list(range(FRAMES)))
+
+    def test_luma_range(self):
+        def read_luma(luma_range: str):
+            stage = GetVideoFrame(self.path, {"luma": True, "luma_range": luma_range})
+            stage.execute()
+            stage.execute()
+            stage.on_destroy()
+
+            return int(stage.frame.get_luma().mean())
+
+        # Motion JPEG is full range, like the BGR to gray conversion.
+        self.assertEqual(read_luma("full"), 40)
+        self.assertEqual(read_luma("limited"), round((40 - 16) * 255 / 219))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,73 @@
+import unittest
+from types import SimpleNamespace
+
+import numpy as np
+
+from baboon_tracking.models.frame import Frame
+from baboon_tracking.stages.motion_detector.noise_reduction.hysteresis_filter import (
+    HysteresisFilter,
+)
+from pipeline.buffer_pool import BufferPool
+
+
+class TestHysteresisFilter(unittest.TestCase):
+    def setUp(self):
+        self.moving_foreground = SimpleNamespace(moving_foreground=None)
+        self.frame_number = 0
+
+    def create(self, required_motion_observations, required_no_motion_observations):
+        hysteresis_filter = HysteresisFilter(
+            required_motion_observations,
+            required_no_motion_observations,
+            self.moving_foreground,
+            BufferPool(),
+        )
+        hysteresis_filter.show_result_set_runtime_config({"display": False})
+
+        return hysteresis_filter
+
+    def step(self, hysteresis_filter, value):
+        self.frame_number += 1
+        self.moving_foreground.moving_foreground = Frame(
+            np.full((4, 4), value, np.uint8), self.frame_number
+        )
+        hysteresis_filter.execute()
+
+        return hysteresis_filter.moving_foreground.get_frame()
+
+    def test_holds_for_the_required_observations(self):
+        hysteresis_filter = self.create(2, 3)
+
+        self.assertFalse(np.any(self.step(hysteresis_filter, 255)))
+        self.assertTrue(np.all(self.step(hysteresis_filter, 255) == 255))
+        self.assertTrue(np.all(self.step(hysteresis_filter, 0) == 255))
+        self.assertTrue(np.all(self.step(hysteresis_filter, 0) == 255))
+        self.assertFalse(np.any(self.step(hysteresis_filter, 0)))
+
+    def test_counters_saturate(self):
+        hysteresis_filter = self.create(1, 1)
+
+        for _ in range(300):
+            self.assertTrue(np.all(self.step(hysteresis_filter, 255) == 255))
+
+        self.assertTrue(np.all(hysteresis_filter._motion_observations == 255))
+        self.assertFalse(np.any(hysteresis_filter._no_motion_observations))
+
+        for _ in range(300):
+            self.assertFalse(np.any(self.step(hysteresis_filter, 0)))
+
+        self.assertTrue(np.all(hysteresis_filter._no_motion_observations == 255))
+        self.assertFalse(np.any(hysteresis_filter._motion_observations))
+
+    def test_output_is_not_the_state(self):
+        hysteresis_filter = self.create(1, 1)
+
+        first = self.step(hysteresis_filter, 255)
+        second = self.step(hysteresis_filter, 0)
+
+        self.assertTrue(np.all(first == 255))
+        self.assertFalse(np.any(second))
+
+
+if __name__ == "__main__":
+    unittest.main()
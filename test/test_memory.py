@@ -0,0 +1,77 @@
+import sys
+import threading
+import unittest
+from types import SimpleNamespace
+from unittest import mock
+
+import numpy as np
+
+from pipeline import memory
+
+
+class _Stage:
+    def __init__(self, arrays: int = 1):
+        self.outputs = [np.zeros(4) for _ in range(arrays)]
+
+
+class TestMemoryProfiler(unittest.TestCase):
+    def setUp(self):
+        self.profiler = memory.MemoryProfiler()
+        self.addCleanup(self.profiler.stop)
+
+    def _measure_on_thread(self, parent=None):
+        # Measures a stage on another thread while the calling thread has a
+        # measurement open.
+        result = []
+
+        def run():
+            if parent is not None:
+                self.profiler.set_current(parent)
+
+            measurement = self.profiler.begin()
+            result.append(self.profiler.end(measurement, _Stage()))
+
+        thread = threading.Thread(target=run)
+        thread.start()
+        thread.join()
+
+        return result[0]
+
+    def test_does_not_count_arrays_of_other_threads(self):
+        measurement = self.profiler.begin()
+        self.assertEqual(self._measure_on_thread()[3], 1)
+
+        self.assertEqual(self.profiler.end(measurement, _Stage(0))[3], 0)
+
+    def test_counts_arrays_of_the_stages_handed_to_other_threads(self):
+        measurement = self.profiler.begin()
+        self.assertEqual(self._measure_on_thread(measurement)[3], 1)
+
+        self.assertEqual(self.profiler.end(measurement, _Stage(0))[3], 1)
+
+    def test_counts_arrays_of_nested_stages(self):
+        parent = self.profiler.begin()
+        child = self.profiler.begin()
+        self.profiler.end(child, _Stage())
+
+        self.assertEqual(self.profiler.end(parent, _Stage())[3], 2)
+        self.assertIsNone(self.profiler.get_current())
+
+
+class TestGetMaxRss(unittest.TestCase):
+    def _get_max_rss(self, platform: str):
+        usage = SimpleNamespace(ru_maxrss=2048)
+        with mock.patch.object(sys, "platform", platform), mock.patch(
+            "resource.getrusage", return_value=usage
+        ):
+            return memory._get_max_rss()  # pylint: disable=protected-access
+
+    def test_reads_kilobytes_on_linux(self):
+        self.assertEqual(self._get_max_rss("linux"), 2048 * 1024)
+
+    def test_reads_bytes_on_macos(self):
+        self.assertEqual(self._get_max_rss("darwin"), 2048)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,57 @@
+import unittest
+
+import cv2
+import numpy as np
+
+from library import morphology
+
+
+def random_mask(shape=(120, 160)):
+    random = np.random.RandomState(0)
+
+    return ((random.random_sample(shape) > 0.98) * 255).astype(np.uint8)
+
+
+class TestMorphology(unittest.TestCase):
+    def test_octagon_is_close_to_the_ellipse(self):
+        for kernel_size in [6, 14, 24]:
+            point = np.zeros((2 * kernel_size + 1,) * 2, dtype=np.uint8)
+            point[kernel_size, kernel_size] = 255
+            ellipse = cv2.dilate(
+                point,
+                cv2.getStructuringElement(
+                    cv2.MORPH_ELLIPSE, (kernel_size, kernel_size)
+                ),
+            )
+
+            octagon = morphology.dilate(point, kernel_size)
+
+            self.assertLessEqual(
+                np.count_nonzero(octagon != ellipse),
+                np.count_nonzero(ellipse) // 4,
+                kernel_size,
+            )
+
+    def test_dilate_grows_and_erode_shrinks(self):
+        mask = random_mask()
+
+        for kernel_size in [1, 6, 14]:
+            dilated = morphology.dilate(mask, kernel_size)
+            eroded = morphology.erode(dilated, kernel_size)
+
+            self.assertTrue(np.all(dilated >= mask))
+            self.assertTrue(np.all(eroded <= dilated))
+
+    def test_erode_is_dual_to_dilate(self):
+        mask = random_mask()
+        inverse = 255 - mask
+
+        self.assertTrue(
+            np.array_equal(
+                morphology.erode(mask, 14), 255 - morphology.dilate(inverse, 14)
+            )
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
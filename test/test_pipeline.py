@@ -0,0 +1,258 @@
+import threading
+import unittest
+
+from pipeline import Graph, Parallel, Pipelined, Serial, Stage
+from pipeline.decorators import main_thread, stage
+from pipeline.factory import factory
+from pipeline.parent_stage import ParentStage
+from pipeline.stage_result import StageResult
+
+
+class CountMixin:
+    def __init__(self):
+        self.count = None
+
+
+class Count(Stage, CountMixin):
+    def __init__(self, frames=None):
+        Stage.__init__(self)
+        CountMixin.__init__(self)
+
+        self._next = 0
+        self._frames = frames
+
+    def execute(self) -> StageResult:
+        if self._next == self._frames:
+            return StageResult(False, None)
+
+        self.count = self._next
+        self._next += 1
+
+        return StageResult(True, True)
+
+
+class SquareMixin:
+    def __init__(self):
+        self.square = None
+
+
+@stage("count")
+class Square(Stage, SquareMixin):
+    def __init__(self, count: CountMixin):
+        Stage.__init__(self)
+        SquareMixin.__init__(self)
+
+        self._count = count
+
+    def execute(self) -> StageResult:
+        self.square = self._count.count**2
+
+        return StageResult(True, True)
+
+
+class DoubleMixin:
+    def __init__(self):
+        self.double = None
+
+
+@stage("count")
+class Double(Stage, DoubleMixin):
+    def __init__(self, count: CountMixin):
+        Stage.__init__(self)
+        DoubleMixin.__init__(self)
+
+        self._count = count
+
+    def execute(self) -> StageResult:
+        self.double = self._count.count * 2
+
+        return StageResult(True, True)
+
+
+@stage("square")
+@stage("double")
+class Record(Stage):
+    def __init__(self, square: SquareMixin, double: DoubleMixin):
+        Stage.__init__(self)
+
+        self._square = square
+        self._double = double
+        self.outputs = []
+
+    def execute(self) -> StageResult:
+        self.outputs.append((self._square.square, self._double.double))
+
+        return StageResult(True, True)
+
+
+@stage("count")
+class SkipOdd(Stage):
+    def __init__(self, count: CountMixin):
+        Stage.__init__(self)
+
+        self._count = count
+
+    def execute(self) -> StageResult:
+        return StageResult(True, self._count.count % 2 == 0)
+
+
+@main_thread
+class RecordThread(Stage):
+    def __init__(self):
+        Stage.__init__(self)
+
+        self.threads = []
+
+    def execute(self) -> StageResult:
+        self.threads.append(threading.current_thread())
+
+        return StageResult(True, True)
+
+
+def run(pipeline: Stage, steps: int):
+    pipeline.on_init()
+    for _ in range(steps):
+        pipeline.execute()
+    pipeline.on_destroy()
+
+
+class TestParallel(unittest.TestCase):
+    def setUp(self):
+        ParentStage.static_stages = []
+
+    def _create(self, concurrent: bool) -> Serial:
+        return Serial(
+            "Test",
+            None,
+            Count,
+            factory(Parallel, "Branches", {"parallel": concurrent}, Square, Double),
+            Record,
+        )
+
+    def test_matches_sequential_execution(self):
+        sequential = self._create(False)
+        concurrent = self._create(True)
+
+        run(sequential, 5)
+        run(concurrent, 5)
+
+        self.assertEqual(
+            sequential.stages[-1].outputs, [(i * i, 2 * i) for i in range(5)]
+        )
+        self.assertEqual(concurrent.stages[-1].outputs, sequential.stages[-1].outputs)
+
+    def test_main_thread_stage_runs_on_calling_thread(self):
+        parallel = Parallel("Test", None, RecordThread, Count, Count)
+
+        run(parallel, 3)
+
+        self.assertEqual(parallel.stages[0].threads, [threading.main_thread()] * 3)
+
+
+class TestPipelined(unittest.TestCase):
+    def setUp(self):
+        ParentStage.static_stages = []
+
+    def _run_until_end(self, pipeline: Stage):
+        pipeline.on_init()
+        while pipeline.execute().continue_pipeline:
+            pass
+        pipeline.on_destroy()
+
+    def _create(self, execution, *stage_types):
+        ParentStage.static_stages = []
+        return execution(
+            "Test", None, factory(Count, frames=7), *stage_types, Square, Double, Record
+        )
+
+    def test_matches_serial_execution(self):
+        for stage_types in ([], [SkipOdd]):
+            serial = self._create(Serial, *stage_types)
+            pipelined = self._create(Pipelined, *stage_types)
+
+            self._run_until_end(serial)
+            self._run_until_end(pipelined)
+
+            self.assertEqual(pipelined.stages[-1].outputs, serial.stages[-1].outputs)
+            self.assertTrue(serial.stages[-1].outputs)
+
+    def test_stops_workers_at_end(self):
+        pipelined = self._create(Pipelined)
+
+        self._run_until_end(pipelined)
+
+        self.assertFalse(any(w.is_alive() for w in pipelined._workers))
+        self.assertTrue(all(q.empty() for q in pipelined._queues))
+
+    def test_stops_workers_on_destroy(self):
+        pipelined = self._create(Pipelined)
+
+        pipelined.on_init()
+        pipelined.execute()
+        pipelined.on_destroy()
+
+        self.assertFalse(any(w.is_alive() for w in pipelined._workers))
+        self.assertTrue(all(q.empty() for q in pipelined._queues))
+
+    def test_main_thread_stages_run_on_calling_thread(self):
+        pipelined = self._create(Pipelined, RecordThread)
+
+        self._run_until_end(pipelined)
+
+        self.assertEqual(pipelined.stages[1].threads, [threading.main_thread()] * 7)
+        self.assertEqual(len(pipelined._workers), 1)
+        self.assertEqual(
+            pipelined.stages[-1].outputs, [(i * i, 2 * i) for i in range(7)]
+        )
+
+
+class TestGraph(unittest.TestCase):
+    def setUp(self):
+        ParentStage.static_stages = []
+
+    def _create(self, execution, *stage_types):
+        ParentStage.static_stages = []
+        return execution(
+            "Test",
+            None,
+            factory(Count, frames=7),
+            factory(Serial, "Nested", None, *stage_types, Square),
+            Double,
+            Record,
+        )
+
+    def _run_until_end(self, pipeline: Stage):
+        results = []
+
+        pipeline.on_init()
+        while True:
+            result = pipeline.execute()
+            results.append((result.continue_pipeline, result.next_stage))
+
+            if not result.continue_pipeline:
+                break
+        pipeline.on_destroy()
+
+        return results
+
+    def test_matches_serial_execution(self):
+        for stage_types in ([], [SkipOdd]):
+            serial = self._create(Serial, *stage_types)
+            graph = self._create(Graph, *stage_types)
+
+            self.assertEqual(self._run_until_end(graph), self._run_until_end(serial))
+            self.assertEqual(graph.stages[-1].outputs, serial.stages[-1].outputs)
+
+    def test_main_thread_stage_runs_on_calling_thread(self):
+        graph = self._create(Graph, RecordThread)
+
+        self._run_until_end(graph)
+
+        # The stage does not depend on Count, so it may also run for the frame that ends the video.
+        self.assertEqual(
+            set(graph.stages[1].stages[0].threads), {threading.main_thread()}
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,72 @@
+import unittest
+
+import cv2
+import numpy as np
+
+from library.ssc import pack_keypoints, select_keypoints, ssc
+from third_party.ssc import ssc as reference_ssc
+
+
+def random_keypoints(count: int, cols: int, rows: int):
+    random = np.random.RandomState(0)
+
+    return [
+        cv2.KeyPoint(float(x), float(y), 7, -1, float(r))
+        for x, y, r in zip(
+            random.uniform(0, cols - 1, count),
+            random.uniform(0, rows - 1, count),
+            random.randint(0, 50, count),
+        )
+    ]
+
+
+class TestSsc(unittest.TestCase):
+    def test_packs_position_and_response(self):
+        keypoints = random_keypoints(10, 64, 48)
+        packed = pack_keypoints(keypoints)
+
+        self.assertEqual(packed.dtype, np.float32)
+        self.assertListEqual(packed.tolist(), [[*k.pt, k.response] for k in keypoints])
+        self.assertEqual(pack_keypoints([]).shape, (0, 3))
+
+    def test_matches_reference_on_keypoints_ordered_by_response(self):
+        cols, rows = 320, 240
+        keypoints = random_keypoints(2000, cols, rows)
+
+        for num_ret_points in (10, 100, 500):
+            selected = select_keypoints(keypoints, num_ret_points, 0.1, cols, rows)
+            reference = reference_ssc(
+                sorted(keypoints, key=lambda k: k.response, reverse=True),
+                num_ret_points,
+                0.1,
+                cols,
+                rows,
+            )
+
+            self.assertEqual([keypoints[i] for i in selected], reference)
+
+    def test_selects_one_point(self):
+        cols, rows = 320, 240
+        keypoints = random_keypoints(200, cols, rows)
+
+        selected = select_keypoints(keypoints, 1, 0.1, cols, rows)
+
+        self.assertEqual(len(selected), 1)
+        self.assertEqual(
+            keypoints[selected[0]].response, max(k.response for k in keypoints)
+        )
+
+    def test_selects_nothing_without_points(self):
+        self.assertEqual(len(ssc(np.empty((0, 3), np.float32), 10, 0.1, 32, 24)), 0)
+        self.assertEqual(
+            len(select_keypoints(random_keypoints(5, 32, 24), 0, 0.1, 32, 24)), 0
+        )
+
+    def test_keeps_every_point_when_asked_for_more(self):
+        points = pack_keypoints(random_keypoints(5, 32, 24))
+
+        self.assertListEqual(ssc(points, 1000, 0.1, 32, 24).tolist(), list(range(5)))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,114 @@
+import json
+import os
+import tempfile
+import threading
+import unittest
+
+from pipeline import tracing
+from pipeline.telemetry import Telemetry
+
+
+class TestTelemetry(unittest.TestCase):
+    def setUp(self):
+        handle, self.path = tempfile.mkstemp(".jsonl")
+        os.close(handle)
+        self.telemetry = Telemetry(self.path)
+
+    def tearDown(self):
+        os.remove(self.path)
+        tracing.set_frame(None)
+
+    def read_lines(self):
+        self.telemetry.close()
+
+        with open(self.path) as f:
+            return [json.loads(l) for l in f]
+
+    def test_writes_one_line_per_frame(self):
+        for frame in range(3):
+            tracing.set_frame(frame)
+            self.telemetry.count("blobs", frame)
+            self.telemetry.count("blobs")
+            self.telemetry.record("ratio", 0.5)
+            self.telemetry.record("ratio", 0.25)
+
+        self.telemetry.flush(1)
+        tracing.set_frame(2)
+        self.telemetry.count("blobs")
+
+        self.assertListEqual(
+            self.read_lines(),
+            [
+                {"frame": 0, "blobs": 1, "ratio": [0.5, 0.25]},
+                {"frame": 1, "blobs": 2, "ratio": [0.5, 0.25]},
+                {"frame": 2, "blobs": 4, "ratio": [0.5, 0.25]},
+            ],
+        )
+
+    def test_drops_counters_of_flushed_frames(self):
+        tracing.set_frame(0)
+        self.telemetry.count("blobs")
+        tracing.set_frame(1)
+        self.telemetry.count("blobs")
+        self.telemetry.flush(1)
+
+        tracing.set_frame(0)
+        self.telemetry.count("blobs")
+        tracing.set_frame(1)
+        self.telemetry.record("ratio", 1.0)
+        tracing.set_frame(2)
+        self.telemetry.count("blobs")
+
+        self.assertEqual(self.telemetry.late_counters, 2)
+        self.assertListEqual([l["frame"] for l in self.read_lines()], [0, 1, 2])
+
+    def test_writes_counters_outside_of_frames_on_close(self):
+        tracing.set_frame(None)
+        self.telemetry.count("stores")
+        tracing.set_frame(0)
+        self.telemetry.count("blobs")
+        self.telemetry.flush()
+        tracing.set_frame(None)
+        self.telemetry.count("stores")
+        self.telemetry.record("size", 3)
+
+        self.assertListEqual(
+            self.read_lines(),
+            [{"frame": 0, "blobs": 1}, {"frame": None, "stores": 2, "size": 3}],
+        )
+
+    def test_threads_publish_while_flushing(self):
+        frames = 200
+        threads = 4
+        # The frame each thread works on, all of its earlier frames are complete.
+        working = list(range(threads))
+
+        def publish(index):
+            for frame in range(index, frames, threads):
+                working[index] = frame
+                tracing.set_frame(frame)
+                for _ in range(50):
+                    self.telemetry.count("count")
+                    self.telemetry.record("value", frame)
+
+            working[index] = frames
+
+        workers = [threading.Thread(target=publish, args=(i,)) for i in range(threads)]
+        for worker in workers:
+            worker.start()
+        while any(worker.is_alive() for worker in workers):
+            self.telemetry.flush(min(working) - 1)
+        for worker in workers:
+            worker.join()
+
+        lines = self.read_lines()
+
+        self.assertEqual(self.telemetry.late_counters, 0)
+        self.assertListEqual([l["frame"] for l in lines], list(range(frames)))
+        for line in lines:
+            self.assertEqual(line["count"], 50)
+            self.assertListEqual(line["value"], [line["frame"]] * 50)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,153 @@
+import gc
+import os
+import pathlib
+import subprocess
+import sys
+import tempfile
+import unittest
+from types import SimpleNamespace
+
+from baboon_tracking.models.baboon import Baboon
+from baboon_tracking.stages.dead_reckoning import DeadReckoning
+from library.track_store import TrackStore, load
+
+
+def baboons(frame_number: int):
+    return [
+        Baboon((frame_number, i, frame_number + 10, i + 10), str(i), i)
+        for i in range(frame_number % 3)
+    ]
+
+
+def create_dead_reckoning(rconfig):
+    return DeadReckoning(20, 0.5, SimpleNamespace(), SimpleNamespace(), rconfig)
+
+
+def rectangles(frame):
+    return [(b.rectangle, b.identity) for b in frame]
+
+
+class TestTrackStore(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.TemporaryDirectory()
+        self.path = pathlib.Path(self.directory.name) / "store.bin"
+
+    def tearDown(self):
+        self.directory.cleanup()
+
+    def test_gets_recent_and_spilled_frames(self):
+        store = TrackStore(str(self.path), window=2)
+        for frame_number in range(1, 8):
+            store.set(frame_number, baboons(frame_number))
+
+        for frame_number in range(1, 8):
+            self.assertIn(frame_number, store)
+            self.assertListEqual(
+                rectangles(store.get(frame_number)), rectangles(baboons(frame_number))
+            )
+
+        self.assertNotIn(8, store)
+        self.assertIsNone(store.get(8))
+        store.close()
+
+    def test_loads_a_store_that_was_not_closed(self):
+        store = TrackStore(str(self.path), window=2)
+        for frame_number in range(1, 8):
+            store.set(frame_number, baboons(frame_number))
+
+        loaded = load(str(self.path))
+
+        self.assertListEqual(sorted(loaded.keys()), list(range(1, 6)))
+        for frame_number, frame in loaded.items():
+            self.assertListEqual(rectangles(frame), rectangles(baboons(frame_number)))
+        store.close()
+
+    def test_load_skips_a_cut_short_frame(self):
+        store = TrackStore(str(self.path), window=1)
+        for frame_number in range(1, 7):
+            store.set(frame_number, baboons(frame_number))
+        store.close()
+
+        record_path, index_path = store.paths
+        with open(record_path, "r+b") as f:
+            f.truncate(record_path.stat().st_size - 1)
+        with open(index_path, "ab") as f:
+            f.write(b"\0" * 5)
+
+        loaded = load(str(self.path))
+
+        # Frame 5 held the last records, frame 6 was never spilled.
+        self.assertListEqual(sorted(loaded.keys()), [1, 2, 3, 4])
+
+    def test_runs_spill_to_their_own_files(self):
+        first = create_dead_reckoning({})
+        second = create_dead_reckoning({})
+        for frame_number in range(1, 6):
+            first.set(frame_number, baboons(frame_number))
+            second.set(frame_number, baboons(frame_number))
+        paths = [*first._all_baboons.paths, *second._all_baboons.paths]
+
+        self.assertEqual(len(set(paths)), 4)
+        self.assertTrue(all(path.exists() for path in paths))
+        self.assertTrue(
+            all(path.parent == pathlib.Path(tempfile.gettempdir()) for path in paths)
+        )
+
+        first.on_destroy()
+        second.on_destroy()
+
+        self.assertFalse(any(path.exists() for path in paths))
+
+    def test_temporary_store_is_created_on_the_first_spill(self):
+        store = TrackStore(window=2)
+        store.set(1, baboons(1))
+        store.set(2, baboons(2))
+
+        self.assertTupleEqual(store.paths, (None, None))
+        store.close()
+
+    def test_collected_temporary_store_is_removed(self):
+        store = TrackStore(window=1)
+        store.set(1, baboons(1))
+        store.set(2, baboons(2))
+        paths = store.paths
+
+        self.assertTrue(all(path.exists() for path in paths))
+
+        del store
+        gc.collect()
+
+        self.assertFalse(any(path.exists() for path in paths))
+
+    def test_temporary_store_is_removed_at_exit(self):
+        script = (
+            "from baboon_tracking.models.baboon import Baboon\n"
+            "from library.track_store import TrackStore\n"
+            "store = TrackStore(window=1)\n"
+            "store.set(1, [Baboon((0, 0, 1, 1))])\n"
+            "store.set(2, [])\n"
+            "print(*store.paths, sep='\\n')\n"
+        )
+        output = subprocess.run(
+            [sys.executable, "-c", script],
+            env={**os.environ, "PYTHONPATH": os.pathsep.join(sys.path)},
+            stdout=subprocess.PIPE,
+            check=True,
+            universal_newlines=True,
+        ).stdout
+        paths = [pathlib.Path(p) for p in output.split()]
+
+        self.assertEqual(len(paths), 2)
+        self.assertFalse(any(path.exists() for path in paths))
+
+    def test_keeps_the_requested_store(self):
+        dead_reckoning = create_dead_reckoning({"track_store": str(self.path)})
+        for frame_number in range(1, 6):
+            dead_reckoning.set(frame_number, baboons(frame_number))
+        dead_reckoning.on_destroy()
+
+        self.assertListEqual(sorted(load(str(self.path)).keys()), [1, 2, 3])
+
+
+if __name__ == "__main__":
+    unittest.main()
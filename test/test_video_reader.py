@@ -0,0 +1,61 @@
+import unittest
+
+import numpy as np
+
+from library.video_reader import VideoReader
+
+
+class _Capture:
+    def __init__(self, frames: int, error: Exception = None):
+        self._frames = frames
+        self._error = error
+
+    def read(self, buffer):
+        if self._frames == 0:
+            if self._error is not None:
+                raise self._error
+
+            return False, None
+
+        self._frames -= 1
+        buffer[:] = self._frames
+        return True, buffer
+
+
+class TestVideoReader(unittest.TestCase):
+    def _reader(self, capture: _Capture):
+        reader = VideoReader(capture, 2, lambda: np.empty((2, 2), np.uint8))
+        self.addCleanup(reader.stop)
+
+        return reader
+
+    def test_reads_until_the_end(self):
+        reader = self._reader(_Capture(3))
+
+        values = []
+        while True:
+            success, frame = reader.read()
+            if not success:
+                break
+            values.append(int(frame[0, 0]))
+
+        self.assertListEqual(values, [2, 1, 0])
+
+    def test_raises_the_decoder_error(self):
+        reader = self._reader(_Capture(1, RuntimeError("corrupt stream")))
+
+        self.assertTrue(reader.read()[0])
+        with self.assertRaisesRegex(RuntimeError, "corrupt stream"):
+            reader.read()
+
+    def test_stopped_reader_ends_the_video(self):
+        reader = self._reader(_Capture(10))
+
+        reader.read()
+        reader.stop()
+        while reader.read()[0]:
+            pass
+
+
+if __name__ == "__main__":
+    unittest.main()